@@ -1,4 +1,7 @@
 @PACKAGE_INIT@
 
+include(CMakeFindDependencyMacro)
+find_dependency(Threads)
+
 include("${CMAKE_CURRENT_LIST_DIR}/vertexTargets.cmake")
 check_required_components("@PROJECT_NAME@")
\ No newline at end of file
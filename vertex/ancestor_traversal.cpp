@@ -0,0 +1 @@
+#include <vertex/ancestor_traversal.h>
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <vertex/traversal.h>
+#include <map>
+#include <queue>
+#include <utility>
+
+namespace vertex {
+
+/** Builds the child to parent index of vertices, holding one (child, parent)
+ * entry per link. A managed_container with an EdgeMap maintains the same
+ * index as vertices are inserted and erased, in parents() */
+template <typename Container>
+std::multimap<typename Container::key_type, typename Container::key_type>
+parent_index(const Container& vertices);
+
+/** Breadth first traversal from a vertex up through its parents to every
+ * root above it, nearest ancestors first.
+ *
+ * ParentMap is a multimap from each child key to the keys of its parents,
+ * such as the result of parent_index or managed_container::parents(), so
+ * that the ancestors are found in time proportional to their number rather
+ * than by a scan forward from every root. The predicate is tested on each
+ * edge in its downward orientation, from parent to child. Visited defaults
+ * to visited_set, as the ancestors of a vertex shared by several parents
+ * usually meet again further up. */
+template <typename Container,
+          typename ParentMap = std::multimap<typename Container::key_type,
+                                             typename Container::key_type>,
+          typename Predicate = predicate_function<Container>,
+          typename Visited = visited_set<Container>>
+class ancestor_traversal
+    : public traversal<
+          Container,
+          ancestor_traversal<Container, ParentMap, Predicate, Visited>,
+          Predicate, Visited> {
+ public:
+  using base_type =
+      traversal<Container, ancestor_traversal, Predicate, Visited>;
+  using base_type::is_traversable;
+  using base_type::position;
+  using base_type::vertices;
+  using typename base_type::predicate_type;
+  using typename base_type::size_type;
+
+  ancestor_traversal(
+      const Container& vertices, const ParentMap& parents,
+      typename Container::const_iterator start,
+      predicate_type predicate = typename base_type::unconditional_traversal(),
+      size_type max_depth = base_type::unlimited);
+
+  const ParentMap& parents() const;
+
+  /** Returns true if the current position has no parents */
+  bool is_root() const;
+
+  ancestor_traversal begin() const;
+
+  bool next();
+
+ private:
+  friend base_type;
+
+  using entry = std::pair<typename base_type::vertex_iterator, size_type>;
+
+  const ParentMap* parents_;
+  copy_on_write<std::queue<entry>> to_visit_;
+};
+
+template <typename Container>
+std::multimap<typename Container::key_type, typename Container::key_type>
+parent_index(const Container& vertices) {
+  auto result = std::multimap<typename Container::key_type,
+                              typename Container::key_type>();
+  for (const auto& [key, vertex] : vertices) {
+    for (const auto& link : vertex) {
+      result.emplace(link, key);
+    }
+  }
+  return result;
+}
+
+template <typename Container, typename ParentMap, typename Predicate,
+          typename Visited>
+ancestor_traversal<Container, ParentMap, Predicate, Visited>::
+    ancestor_traversal(const Container& vertices, const ParentMap& parents,
+                       typename Container::const_iterator start,
+                       predicate_type predicate, size_type max_depth)
+    : base_type(vertices, start, std::move(predicate), max_depth),
+      parents_(&parents) {}
+
+template <typename Container, typename ParentMap, typename Predicate,
+          typename Visited>
+const ParentMap&
+ancestor_traversal<Container, ParentMap, Predicate, Visited>::parents() const {
+  return *parents_;
+}
+
+template <typename Container, typename ParentMap, typename Predicate,
+          typename Visited>
+bool ancestor_traversal<Container, ParentMap, Predicate, Visited>::is_root()
+    const {
+  auto range = parents_->equal_range(position()->first);
+  return range.first == range.second;
+}
+
+template <typename Container, typename ParentMap, typename Predicate,
+          typename Visited>
+ancestor_traversal<Container, ParentMap, Predicate, Visited>
+ancestor_traversal<Container, ParentMap, Predicate, Visited>::begin() const {
+  return ancestor_traversal(vertices(), parents(), base_type::root(),
+                            base_type::predicate(), base_type::max_depth());
+}
+
+template <typename Container, typename ParentMap, typename Predicate,
+          typename Visited>
+bool ancestor_traversal<Container, ParentMap, Predicate, Visited>::next() {
+  auto& to_visit = to_visit_.mutate();
+  auto depth = base_type::depth();
+  if (position() != vertices().end() && depth < base_type::max_depth()) {
+    const auto& child = position()->first;
+    auto range = parents_->equal_range(child);
+    for (auto it = range.first; it != range.second; ++it) {
+      auto parent = vertices().find(it->second);
+      if (parent != vertices().end() && is_traversable(parent->first, child) &&
+          base_type::enter(parent)) {
+        to_visit.emplace(parent, depth + 1);
+      }
+    }
+  }
+  if (to_visit.empty()) {
+    return false;
+  }
+  base_type::position(to_visit.front().first, to_visit.front().second);
+  to_visit.pop();
+  return true;
+}
+
+}  // namespace vertex
@@ -0,0 +1 @@
+#include <vertex/async_traversal.h>
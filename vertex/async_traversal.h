@@ -0,0 +1,358 @@
+#pragma once
+
+#include <vertex/edge.h>
+#include <vertex/predicate.h>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace vertex {
+
+/** Tuning for the async traversals */
+struct async_traversal_options {
+  /** Number of fetches kept in flight. The fetch a traversal waits on is
+   * issued even if the window is full */
+  std::size_t window = 64;
+
+  /** Depth below which the traversal does not descend */
+  std::size_t max_depth = std::numeric_limits<std::size_t>::max();
+};
+
+/** A Store over a Container held in memory, whose fetches are ready at once.
+ *
+ * A Store defines key_type and mapped_type, and fetch(key), which returns a
+ * future-like object whose get() waits for the lookup and yields a value
+ * that is empty if key is missing, and otherwise dereferences to the
+ * mapped_type. A store backed by disk or a remote service returns its
+ * futures before the lookup completes, so that many may be in flight. */
+template <typename Container>
+class container_store {
+ public:
+  using key_type = typename Container::key_type;
+  using mapped_type = typename Container::mapped_type;
+  using future_type = std::future<std::optional<mapped_type>>;
+
+  explicit container_store(const Container& vertices);
+
+  future_type fetch(const key_type& key) const;
+
+ private:
+  const Container* vertices_;
+};
+
+/** The fetches of an async traversal over a Store. Each frame holds a
+ * vertex and the futures of the children it has fetched ahead of its
+ * cursor; up to window of these are in flight across all frames. The
+ * predicate is tested on each edge before its child is fetched, so that a
+ * pruned child costs no lookup */
+template <typename Store, typename Predicate>
+class fetch_window {
+ public:
+  using key_type = typename Store::key_type;
+  using edge_type = edge<Store>;
+  using future_type = decltype(std::declval<const Store&>().fetch(
+      std::declval<const key_type&>()));
+  using result_type =
+      std::decay_t<decltype(std::declval<future_type&>().get())>;
+  using vertex_type = std::decay_t<decltype(*std::declval<result_type&>())>;
+  using link_iterator = decltype(std::declval<const vertex_type&>().begin());
+
+  struct frame {
+    key_type key;
+    result_type vertex;
+    std::size_t depth;
+    link_iterator ahead;  // the next child to test and fetch
+    std::deque<std::pair<key_type, future_type>> requests;  // not yet visited
+  };
+
+  fetch_window(const Store& store, Predicate predicate,
+               const async_traversal_options& options);
+
+  /** Starts fetching key, whether or not the window has room */
+  future_type issue(const key_type& key);
+
+  /** Waits for a fetch started by issue */
+  result_type get(future_type& request);
+
+  /** Returns true if another fetch may be issued ahead */
+  bool has_room() const;
+
+  /** Tests the edge from source to target, as the traversals do */
+  bool is_traversable(const key_type& source, const key_type& target);
+
+  /** Pushes a frame for vertex, which is not expanded at max_depth */
+  void enter(std::deque<frame>& frames, key_type key, result_type vertex,
+             std::size_t depth);
+
+  /** Waits for the next traversable child of top, first fetching its
+   * following traversable siblings while the window has room
+   * @return false if top has no more traversable children */
+  bool next_child(frame& top, key_type& key, result_type& child);
+
+ private:
+  /** Issues the fetch of the next traversable child of top
+   * @return false if top has no more traversable children */
+  bool fetch_ahead(frame& top);
+
+  const Store* store_;
+  Predicate predicate_;
+  async_traversal_options options_;
+  std::size_t in_flight_ = 0;
+};
+
+/** Pre-order traversal of the vertices reachable from root in store, which
+ * calls visit(key, vertex, depth) in the order of pre_order_traversal.
+ *
+ * While a vertex is visited, the fetches of the siblings which follow it are
+ * kept in flight, so that a slow store serves up to options.window lookups
+ * at once rather than one child at a time.
+ * @return the number of vertices visited */
+template <typename Store, typename Visitor,
+          typename Predicate = unconditional<Store>>
+std::size_t async_pre_order(
+    const Store& store, const typename Store::key_type& root, Visitor visit,
+    const async_traversal_options& options = async_traversal_options(),
+    Predicate predicate = Predicate());
+
+/** Post-order traversal, which calls visit(key, vertex, depth) on every
+ * child of a vertex, in link order, before the vertex itself, in the order
+ * of csr_post_order_traversal. Fetches are kept in flight as in
+ * async_pre_order.
+ * @return the number of vertices visited */
+template <typename Store, typename Visitor,
+          typename Predicate = unconditional<Store>>
+std::size_t async_post_order(
+    const Store& store, const typename Store::key_type& root, Visitor visit,
+    const async_traversal_options& options = async_traversal_options(),
+    Predicate predicate = Predicate());
+
+/** Breadth first traversal, which calls visit(key, vertex, depth) in the
+ * order of breadth_first_traversal. The first options.window vertices of the
+ * queue are fetched ahead of their visit.
+ * @return the number of vertices visited */
+template <typename Store, typename Visitor,
+          typename Predicate = unconditional<Store>>
+std::size_t async_breadth_first(
+    const Store& store, const typename Store::key_type& root, Visitor visit,
+    const async_traversal_options& options = async_traversal_options(),
+    Predicate predicate = Predicate());
+
+template <typename Container>
+container_store<Container>::container_store(const Container& vertices)
+    : vertices_(&vertices) {}
+
+template <typename Container>
+typename container_store<Container>::future_type
+container_store<Container>::fetch(const key_type& key) const {
+  auto result = std::promise<std::optional<mapped_type>>();
+  auto it = vertices_->find(key);
+  if (it == vertices_->end()) {
+    result.set_value(std::nullopt);
+  } else {
+    result.set_value(it->second);
+  }
+  return result.get_future();
+}
+
+template <typename Store, typename Predicate>
+fetch_window<Store, Predicate>::fetch_window(
+    const Store& store, Predicate predicate,
+    const async_traversal_options& options)
+    : store_(&store), predicate_(std::move(predicate)), options_(options) {}
+
+template <typename Store, typename Predicate>
+typename fetch_window<Store, Predicate>::future_type
+fetch_window<Store, Predicate>::issue(const key_type& key) {
+  auto result = store_->fetch(key);
+  ++in_flight_;
+  return result;
+}
+
+template <typename Store, typename Predicate>
+typename fetch_window<Store, Predicate>::result_type
+fetch_window<Store, Predicate>::get(future_type& request) {
+  --in_flight_;
+  return request.get();
+}
+
+template <typename Store, typename Predicate>
+bool fetch_window<Store, Predicate>::has_room() const {
+  return in_flight_ < options_.window;
+}
+
+template <typename Store, typename Predicate>
+bool fetch_window<Store, Predicate>::is_traversable(const key_type& source,
+                                                    const key_type& target) {
+  if constexpr (is_unconditional_v<Store, Predicate>) {
+    (void)source;
+    (void)target;
+    return true;
+  } else if constexpr (std::is_same_v<Predicate, predicate_function<Store>>) {
+    return !predicate_ || predicate_(edge_type(source, target));
+  } else {
+    return static_cast<bool>(predicate_(edge_type(source, target)));
+  }
+}
+
+template <typename Store, typename Predicate>
+void fetch_window<Store, Predicate>::enter(std::deque<frame>& frames,
+                                           key_type key, result_type vertex,
+                                           std::size_t depth) {
+  // the links are resolved in place, as moving vertex may invalidate them
+  frames.push_back(frame{std::move(key), std::move(vertex), depth, {}, {}});
+  auto& top = frames.back();
+  top.ahead = depth < options_.max_depth ? top.vertex->begin()
+                                         : top.vertex->end();
+}
+
+template <typename Store, typename Predicate>
+bool fetch_window<Store, Predicate>::fetch_ahead(frame& top) {
+  for (auto end = top.vertex->end(); top.ahead != end;) {
+    const auto& link = *top.ahead++;
+    if (is_traversable(top.key, link)) {
+      top.requests.emplace_back(link, issue(link));
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename Store, typename Predicate>
+bool fetch_window<Store, Predicate>::next_child(frame& top, key_type& key,
+                                                result_type& child) {
+  if (top.requests.empty() && !fetch_ahead(top)) {  // fetch the child needed
+    return false;
+  }
+  while (has_room() && fetch_ahead(top)) {
+  }
+  auto& request = top.requests.front();
+  key = std::move(request.first);
+  child = get(request.second);
+  top.requests.pop_front();
+  return true;
+}
+
+template <typename Store, typename Visitor, typename Predicate>
+std::size_t async_pre_order(const Store& store,
+                            const typename Store::key_type& root,
+                            Visitor visit,
+                            const async_traversal_options& options,
+                            Predicate predicate) {
+  using window_type = fetch_window<Store, Predicate>;
+  auto window = window_type(store, std::move(predicate), options);
+  auto request = window.issue(root);
+  auto vertex = window.get(request);
+  if (!vertex) {
+    return 0;
+  }
+  visit(root, *vertex, std::size_t(0));
+  auto visited = std::size_t(1);
+  auto frames = std::deque<typename window_type::frame>();
+  window.enter(frames, root, std::move(vertex), 0);
+  auto key = typename Store::key_type();
+  auto child = typename window_type::result_type();
+  while (!frames.empty()) {
+    auto& top = frames.back();
+    if (!window.next_child(top, key, child)) {
+      frames.pop_back();
+      continue;
+    }
+    if (child) {
+      auto depth = top.depth + 1;
+      visit(key, *child, depth);
+      ++visited;
+      window.enter(frames, std::move(key), std::move(child), depth);
+    }
+  }
+  return visited;
+}
+
+template <typename Store, typename Visitor, typename Predicate>
+std::size_t async_post_order(const Store& store,
+                             const typename Store::key_type& root,
+                             Visitor visit,
+                             const async_traversal_options& options,
+                             Predicate predicate) {
+  using window_type = fetch_window<Store, Predicate>;
+  auto window = window_type(store, std::move(predicate), options);
+  auto request = window.issue(root);
+  auto vertex = window.get(request);
+  if (!vertex) {
+    return 0;
+  }
+  auto visited = std::size_t(0);
+  auto frames = std::deque<typename window_type::frame>();
+  window.enter(frames, root, std::move(vertex), 0);
+  auto key = typename Store::key_type();
+  auto child = typename window_type::result_type();
+  while (!frames.empty()) {
+    auto& top = frames.back();
+    if (!window.next_child(top, key, child)) {  // all children visited
+      visit(top.key, *top.vertex, top.depth);
+      ++visited;
+      frames.pop_back();
+    } else if (child) {
+      window.enter(frames, std::move(key), std::move(child), top.depth + 1);
+    }
+  }
+  return visited;
+}
+
+template <typename Store, typename Visitor, typename Predicate>
+std::size_t async_breadth_first(const Store& store,
+                                const typename Store::key_type& root,
+                                Visitor visit,
+                                const async_traversal_options& options,
+                                Predicate predicate) {
+  using key_type = typename Store::key_type;
+  using window_type = fetch_window<Store, Predicate>;
+  struct entry {
+    key_type key;
+    std::size_t depth;
+    std::optional<typename window_type::future_type> request;
+  };
+  auto window = window_type(store, std::move(predicate), options);
+  auto request = window.issue(root);
+  auto vertex = window.get(request);
+  if (!vertex) {
+    return 0;
+  }
+  auto to_visit = std::deque<entry>();
+  auto ahead = std::size_t(0);  // entries of to_visit already fetched
+  auto visited = std::size_t(0);
+  auto expand = [&](const key_type& key, const auto& value, std::size_t depth) {
+    visit(key, value, depth);
+    ++visited;
+    if (depth < options.max_depth) {
+      for (const auto& link : value) {  // test each edge before fetching
+        if (window.is_traversable(key, link)) {
+          to_visit.push_back(entry{link, depth + 1, std::nullopt});
+        }
+      }
+    }
+  };
+  expand(root, *vertex, 0);
+  while (!to_visit.empty()) {
+    if (ahead == 0) {  // fetch the vertex needed now
+      to_visit.front().request = window.issue(to_visit.front().key);
+      ++ahead;
+    }
+    for (; ahead < to_visit.size() && window.has_room(); ++ahead) {
+      to_visit[ahead].request = window.issue(to_visit[ahead].key);
+    }
+    auto current = std::move(to_visit.front());
+    to_visit.pop_front();
+    --ahead;
+    auto child = window.get(*current.request);
+    if (child) {
+      expand(current.key, *child, current.depth);
+    }
+  }
+  return visited;
+}
+
+}  // namespace vertex
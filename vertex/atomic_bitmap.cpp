@@ -0,0 +1,34 @@
+#include <vertex/atomic_bitmap.h>
+
+namespace vertex {
+
+atomic_bitmap::atomic_bitmap(size_type size)
+    : size_(size),
+      words_(std::make_unique<std::atomic<word_type>[]>(
+          (size + word_bits - 1) / word_bits)) {
+  reset();
+}
+
+atomic_bitmap::size_type atomic_bitmap::size() const { return size_; }
+
+bool atomic_bitmap::test(size_type pos) const {
+  auto mask = word_type(1) << (pos % word_bits);
+  return (words_[pos / word_bits].load(std::memory_order_relaxed) & mask) != 0;
+}
+
+bool atomic_bitmap::set(size_type pos) {
+  auto mask = word_type(1) << (pos % word_bits);
+  auto& word = words_[pos / word_bits];
+  if ((word.load(std::memory_order_relaxed) & mask) != 0) {
+    return false;  // avoid the read-modify-write when already set
+  }
+  return (word.fetch_or(mask, std::memory_order_relaxed) & mask) == 0;
+}
+
+void atomic_bitmap::reset() {
+  for (size_type i = 0, n = (size_ + word_bits - 1) / word_bits; i < n; ++i) {
+    words_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace vertex
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace vertex {
+
+/** A fixed-size set of bits which may be tested and set concurrently, e.g.
+ * to record visited vertices by index from several threads */
+class atomic_bitmap {
+ public:
+  using size_type = std::size_t;
+
+  /** Creates a bitmap of size bits, all clear */
+  explicit atomic_bitmap(size_type size = 0);
+
+  /** Returns the number of bits */
+  [[nodiscard]] size_type size() const;
+
+  /** Returns true if the bit at pos is set */
+  bool test(size_type pos) const;
+
+  /** Sets the bit at pos
+   * @return true if this call changed the bit from clear to set */
+  bool set(size_type pos);
+
+  /** Clears every bit. Must not race with test() or set() */
+  void reset();
+
+ private:
+  using word_type = std::uint64_t;
+  static constexpr size_type word_bits = 64;
+
+  size_type size_;
+  std::unique_ptr<std::atomic<word_type>[]> words_;
+};
+
+}  // namespace vertex
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <vertex/prefetch.h>
 #include <vertex/traversal.h>
+#include <boost/iterator/function_output_iterator.hpp>
 #include <memory>
 #include <queue>
 
@@ -8,13 +10,19 @@ namespace vertex {
 /**@TODO Allow construction AT a given parent/child. Store child link pointer.
  * Ensure Iterator can be used to construct container of values */
 
-/** Bredth first tree traversal */
-template <typename Container>
+/** Bredth first tree traversal. Each queued vertex carries its depth, and
+ * vertices at max_depth are not expanded. The children of a vertex are found
+ * together through find_many */
+template <typename Container,
+          typename Predicate = predicate_function<Container>,
+          typename Visited = no_visited_set>
 class breadth_first_traversal
-    : public traversal<Container, breadth_first_traversal<Container>> {
+    : public traversal<Container,
+                       breadth_first_traversal<Container, Predicate, Visited>,
+                       Predicate, Visited> {
  public:
-  using self_type = breadth_first_traversal<Container>;
-  using base_type = traversal<Container, self_type>;
+  using self_type = breadth_first_traversal<Container, Predicate, Visited>;
+  using base_type = traversal<Container, self_type, Predicate, Visited>;
   using base_type::base_type;
   using base_type::is_traversable;
   using base_type::position;
@@ -24,32 +32,35 @@ class breadth_first_traversal
   bool next();
 
  private:
-  std::queue<typename base_type::edge_type> to_visit_;
+  friend base_type;
+
+  using entry = std::pair<typename base_type::vertex_iterator,
+                          typename base_type::size_type>;
+
+  copy_on_write<std::queue<entry>> to_visit_;
 };
 
-template <typename Container>
-bool breadth_first_traversal<Container>::next() {
-  auto result = false;
-  if (position() != vertices().end()) {
-    for (const auto& child : position()->second) {
-      auto e = edge<Container>(position()->first, child);
-      if (is_traversable(e)) {
-        to_visit_.push(e);
-      }
-    }
-  } else {
-    result = false;
+template <typename Container, typename Predicate, typename Visited>
+bool breadth_first_traversal<Container, Predicate, Visited>::next() {
+  auto& to_visit = to_visit_.mutate();
+  auto depth = base_type::depth();
+  if (position() != vertices().end() && depth < base_type::max_depth()) {
+    const auto& links = position()->second;
+    find_many(vertices(), links.begin(), links.end(),
+              boost::make_function_output_iterator([&](const auto& child) {
+                if (child != vertices().end() &&
+                    is_traversable(position()->first, child->first) &&
+                    base_type::enter(child)) {
+                  to_visit.emplace(child, depth + 1);
+                }
+              }));
   }
-  while (!to_visit_.empty()) {
-    auto edge = to_visit_.front();
-    to_visit_.pop();
-    base_type::position(vertices().find(edge.target()));
-    if (position() != vertices().end()) {
-      result = true;
-      break;
-    }
+  if (to_visit.empty()) {
+    return false;
   }
-  return result;
+  base_type::position(to_visit.front().first, to_visit.front().second);
+  to_visit.pop();
+  return true;
 }
 
 }  // namespace vertex
@@ -0,0 +1 @@
+#include <vertex/copy_on_write.h>
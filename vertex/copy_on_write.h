@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace vertex {
+
+/** Holds a value which copies share until one of them mutates it, e.g. the
+ * frontier of a traversal, so that copying an iterator which is never
+ * advanced costs no more than copying a pointer.
+ *
+ * A default constructed copy_on_write holds no value. Empty types, such as
+ * stateless predicates, are stored inline instead. */
+template <typename T, bool Inline = std::is_empty_v<T>>
+class copy_on_write {
+ public:
+  using value_type = T;
+
+  copy_on_write() = default;
+
+  /** Holds the given value, unshared */
+  explicit copy_on_write(T value);
+
+  /** Returns true if a value is held */
+  explicit operator bool() const;
+
+  /** Returns the held value for reading */
+  const T& get() const;
+
+  /** Returns the held value for writing, first copying it if it is shared.
+   * If no value is held, a default constructed one is created */
+  T& mutate();
+
+ private:
+  std::shared_ptr<T> value_;
+};
+
+/** Inline storage for an empty type, which has no state to share */
+template <typename T>
+class copy_on_write<T, true> {
+ public:
+  using value_type = T;
+
+  copy_on_write() = default;
+  explicit copy_on_write(T value);
+  explicit operator bool() const;
+  const T& get() const;
+  T& mutate();
+
+ private:
+  T value_;
+};
+
+template <typename T, bool Inline>
+copy_on_write<T, Inline>::copy_on_write(T value)
+    : value_(std::make_shared<T>(std::move(value))) {}
+
+template <typename T, bool Inline>
+copy_on_write<T, Inline>::operator bool() const {
+  return static_cast<bool>(value_);
+}
+
+template <typename T, bool Inline>
+const T& copy_on_write<T, Inline>::get() const {
+  assert(value_);
+  return *value_;
+}
+
+template <typename T, bool Inline>
+T& copy_on_write<T, Inline>::mutate() {
+  if constexpr (std::is_default_constructible_v<T>) {
+    if (!value_) {
+      value_ = std::make_shared<T>();
+    }
+  }
+  assert(value_);
+  if (value_.use_count() > 1) {
+    value_ = std::make_shared<T>(*value_);
+  }
+  return *value_;
+}
+
+template <typename T>
+copy_on_write<T, true>::copy_on_write(T value) : value_(std::move(value)) {}
+
+template <typename T>
+copy_on_write<T, true>::operator bool() const {
+  return true;
+}
+
+template <typename T>
+const T& copy_on_write<T, true>::get() const {
+  return value_;
+}
+
+template <typename T>
+T& copy_on_write<T, true>::mutate() {
+  return value_;
+}
+
+}  // namespace vertex
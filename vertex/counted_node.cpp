@@ -0,0 +1 @@
+#include <vertex/counted_node.h>
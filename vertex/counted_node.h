@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace vertex {
+
+/** A Node which carries an intrusive reference count, for storage in a
+ * managed_container which keeps no EdgeMap.
+ *
+ * The count belongs to the stored vertex rather than to its value: copies
+ * start unreferenced, and assigning a new value keeps the existing count. */
+template <typename Node>
+class counted_node : public Node {
+ public:
+  using node_type = Node;
+  using size_type = std::size_t;
+
+  counted_node() = default;
+
+  /** Wraps a node with no references */
+  counted_node(Node node);  // NOLINT
+
+  counted_node(const counted_node& other);
+  counted_node(counted_node&& other) noexcept;
+  counted_node& operator=(const counted_node& other);
+  counted_node& operator=(counted_node&& other) noexcept;
+
+  /** Returns the number of parent edges referencing this vertex */
+  size_type references() const;
+
+  /** Adds a reference, returning the new count */
+  size_type acquire();
+
+  /** Removes a reference, returning the new count */
+  size_type release();
+
+  /** Sets the count, e.g. once it has been recomputed from the graph */
+  void reset(size_type references);
+
+ private:
+  size_type references_ = 0;
+};
+
+template <typename Node>
+counted_node<Node>::counted_node(Node node) : Node(std::move(node)) {}
+
+template <typename Node>
+counted_node<Node>::counted_node(const counted_node& other)
+    : Node(static_cast<const Node&>(other)) {}
+
+template <typename Node>
+counted_node<Node>::counted_node(counted_node&& other) noexcept
+    : Node(static_cast<Node&&>(other)) {}
+
+template <typename Node>
+counted_node<Node>& counted_node<Node>::operator=(const counted_node& other) {
+  Node::operator=(static_cast<const Node&>(other));
+  return *this;
+}
+
+template <typename Node>
+counted_node<Node>& counted_node<Node>::operator=(
+    counted_node&& other) noexcept {
+  Node::operator=(static_cast<Node&&>(other));
+  return *this;
+}
+
+template <typename Node>
+typename counted_node<Node>::size_type counted_node<Node>::references() const {
+  return references_;
+}
+
+template <typename Node>
+typename counted_node<Node>::size_type counted_node<Node>::acquire() {
+  return ++references_;
+}
+
+template <typename Node>
+typename counted_node<Node>::size_type counted_node<Node>::release() {
+  return references_ == 0 ? 0 : --references_;
+}
+
+template <typename Node>
+void counted_node<Node>::reset(size_type references) {
+  references_ = references;
+}
+
+}  // namespace vertex
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace vertex {
+
+/** A read-only snapshot of a Container in compressed sparse row form.
+ *
+ * Vertices are copied into one contiguous array and addressed by index. The
+ * links of vertex i are resolved once, at construction, into the contiguous
+ * child index range [offsets[i], offsets[i + 1]). Links which do not resolve
+ * to a stored vertex are kept in place as npos, so that the position of a
+ * child (e.g. left or right) is preserved.
+ *
+ * The snapshot does not observe later changes to the Container. */
+template <typename Container>
+class csr_graph {
+ public:
+  using container_type = Container;
+  using key_type = typename Container::key_type;
+  using mapped_type = typename Container::mapped_type;
+  using value_type = typename Container::value_type;
+  using size_type = std::size_t;
+  using const_reference = const value_type&;
+  using const_iterator = typename std::vector<value_type>::const_iterator;
+  using child_iterator = typename std::vector<size_type>::const_iterator;
+
+  /** Index of a vertex which is not in the graph */
+  static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+  /** The resolved child indices of a vertex */
+  class child_range {
+   public:
+    child_range(child_iterator first, child_iterator last);
+    child_iterator begin() const;
+    child_iterator end() const;
+    [[nodiscard]] size_type size() const;
+    [[nodiscard]] bool empty() const;
+    size_type operator[](size_type pos) const;
+
+   private:
+    child_iterator first_;
+    child_iterator last_;
+  };
+
+  /** Creates an empty graph */
+  csr_graph() = default;
+
+  /** Freezes every vertex of the given container */
+  explicit csr_graph(const Container& vertices);
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  /** Returns the number of vertices */
+  [[nodiscard]] size_type size() const;
+
+  /** Returns true if the graph has no vertices */
+  [[nodiscard]] bool empty() const;
+
+  /** Returns the number of resolved and unresolved child links */
+  [[nodiscard]] size_type edge_count() const;
+
+  /** Returns the index of the vertex with the given key, or npos */
+  size_type index(const key_type& key) const;
+
+  /** Returns the key and node stored at the given index */
+  const_reference operator[](size_type index) const;
+
+  /** Returns the key of the vertex at the given index */
+  const key_type& key(size_type index) const;
+
+  /** Returns the children of the vertex at the given index, in link order */
+  child_range children(size_type index) const;
+
+ private:
+  std::vector<value_type> vertices_;
+  std::vector<size_type> offsets_;
+  std::vector<size_type> children_;
+  std::vector<std::pair<key_type, size_type>> keys_;  // sorted by key
+};
+
+template <typename Container>
+csr_graph<Container>::child_range::child_range(child_iterator first,
+                                               child_iterator last)
+    : first_(std::move(first)), last_(std::move(last)) {}
+
+template <typename Container>
+typename csr_graph<Container>::child_iterator
+csr_graph<Container>::child_range::begin() const {
+  return first_;
+}
+
+template <typename Container>
+typename csr_graph<Container>::child_iterator
+csr_graph<Container>::child_range::end() const {
+  return last_;
+}
+
+template <typename Container>
+typename csr_graph<Container>::size_type
+csr_graph<Container>::child_range::size() const {
+  return static_cast<size_type>(last_ - first_);
+}
+
+template <typename Container>
+bool csr_graph<Container>::child_range::empty() const {
+  return first_ == last_;
+}
+
+template <typename Container>
+typename csr_graph<Container>::size_type csr_graph<Container>::child_range::
+operator[](size_type pos) const {
+  return first_[pos];
+}
+
+template <typename Container>
+csr_graph<Container>::csr_graph(const Container& vertices) {
+  vertices_.reserve(vertices.size());
+  keys_.reserve(vertices.size());
+  for (const auto& vertex : vertices) {
+    keys_.emplace_back(vertex.first, vertices_.size());
+    vertices_.push_back(vertex);
+  }
+  auto by_key = [](const auto& lhs, const auto& rhs) {
+    return lhs.first < rhs.first;
+  };
+  if (!std::is_sorted(keys_.begin(), keys_.end(), by_key)) {
+    std::sort(keys_.begin(), keys_.end(), by_key);
+  }
+  offsets_.reserve(vertices_.size() + 1);
+  offsets_.push_back(0);
+  for (const auto& vertex : vertices_) {  // resolve every link exactly once
+    for (const auto& link : vertex.second) {
+      children_.push_back(index(link));
+    }
+    offsets_.push_back(children_.size());
+  }
+}
+
+template <typename Container>
+typename csr_graph<Container>::const_iterator csr_graph<Container>::begin()
+    const {
+  return vertices_.begin();
+}
+
+template <typename Container>
+typename csr_graph<Container>::const_iterator csr_graph<Container>::end()
+    const {
+  return vertices_.end();
+}
+
+template <typename Container>
+typename csr_graph<Container>::size_type csr_graph<Container>::size() const {
+  return vertices_.size();
+}
+
+template <typename Container>
+bool csr_graph<Container>::empty() const {
+  return vertices_.empty();
+}
+
+template <typename Container>
+typename csr_graph<Container>::size_type csr_graph<Container>::edge_count()
+    const {
+  return children_.size();
+}
+
+template <typename Container>
+typename csr_graph<Container>::size_type csr_graph<Container>::index(
+    const key_type& key) const {
+  auto it = std::lower_bound(
+      keys_.begin(), keys_.end(), key,
+      [](const auto& entry, const key_type& k) { return entry.first < k; });
+  return it != keys_.end() && !(key < it->first) ? it->second : npos;
+}
+
+template <typename Container>
+typename csr_graph<Container>::const_reference csr_graph<Container>::
+operator[](size_type index) const {
+  return vertices_[index];
+}
+
+template <typename Container>
+const typename csr_graph<Container>::key_type& csr_graph<Container>::key(
+    size_type index) const {
+  return vertices_[index].first;
+}
+
+template <typename Container>
+typename csr_graph<Container>::child_range csr_graph<Container>::children(
+    size_type index) const {
+  auto first = children_.begin();
+  return child_range(first + static_cast<std::ptrdiff_t>(offsets_[index]),
+                     first + static_cast<std::ptrdiff_t>(offsets_[index + 1]));
+}
+
+}  // namespace vertex
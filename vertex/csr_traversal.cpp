@@ -0,0 +1 @@
+#include <vertex/csr_traversal.h>
@@ -0,0 +1,512 @@
+#pragma once
+
+#include <vertex/copy_on_write.h>
+#include <vertex/csr_graph.h>
+#include <vertex/edge.h>
+#include <vertex/predicate.h>
+#include <vertex/visited_set.h>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vertex {
+
+/** Base for traversals of a csr_graph, which step between vertex indices
+ * rather than looking up each child in a Container.
+ *
+ * Mirrors traversal: dereferencing yields the Container::value_type at the
+ * current position, and the predicate receives the same edge<Container>
+ * objects. An empty predicate_function, or unconditional<Container>, traverses
+ * every edge without constructing them. As with traversal, copies share the
+ * predicate, frontier and visited set until advanced, end() holds no
+ * frontier, and the copy returned by postfix ++ holds no visited set.
+ *
+ * Visited may be visited_bitmap, to enter each distinct vertex once. Each
+ * traversal reports the depth() of its position and does not descend below
+ * max_depth. */
+template <typename Container, typename Impl,
+          typename Predicate = predicate_function<Container>,
+          typename Visited = no_visited_set>
+class csr_traversal {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using difference_type = std::ptrdiff_t;
+  using graph_type = csr_graph<Container>;
+  using size_type = typename graph_type::size_type;
+  using edge_type = edge<Container>;
+  using predicate_type = Predicate;
+
+  using value_type = typename Container::value_type;
+  using visited_type = Visited;
+  using self_type = csr_traversal<Container, Impl, Predicate, Visited>;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+  using pointer = const value_type*;
+  using const_pointer = const value_type*;
+
+  static constexpr size_type npos = graph_type::npos;
+
+  /** max_depth which places no limit on the depth of a traversal */
+  static constexpr size_type unlimited = npos;
+
+  csr_traversal() = default;
+
+  csr_traversal(const graph_type& graph, size_type root,
+                predicate_type predicate = predicate_type(),
+                size_type max_depth = unlimited);
+
+  const graph_type& graph() const;
+  size_type root() const;
+
+  /** Returns the index of the current vertex, or npos at the end */
+  size_type position() const;
+
+  /** Returns the number of edges from the root to the current position */
+  size_type depth() const;
+
+  /** Returns the depth below which the traversal does not descend */
+  size_type max_depth() const;
+
+  const predicate_type& predicate() const;
+
+  /** Tests the edge from source to target, recording target with the
+   * Visited policy if the predicate passes it
+   * @return false if target is npos, fails the predicate, or was visited */
+  bool is_traversable(size_type source, size_type target);
+
+  Impl begin() const;
+  Impl end() const;
+  Impl& operator++();
+  Impl operator++(int dummy);
+  const_reference operator*() const;
+  const_pointer operator->() const;
+
+  bool operator!=(const self_type& rhs) const;
+  bool operator==(const self_type& rhs) const;
+
+ protected:
+  void position(size_type value);
+
+  /** Moves to a vertex at the given depth */
+  void position(size_type value, size_type depth);
+
+ private:
+  const graph_type* graph_ = nullptr;
+  size_type root_ = npos;
+  size_type position_ = npos;
+  size_type depth_ = 0;
+  size_type max_depth_ = unlimited;
+  copy_on_write<predicate_type> predicate_;
+  copy_on_write<visited_type> visited_;
+};
+
+/** Pre-order traversal of a csr_graph: each frame holds a vertex and the
+ * cursor of its next child, so the depth of a vertex is the height of the
+ * stack beneath it */
+template <typename Container,
+          typename Predicate = predicate_function<Container>,
+          typename Visited = no_visited_set>
+class csr_pre_order_traversal
+    : public csr_traversal<
+          Container, csr_pre_order_traversal<Container, Predicate, Visited>,
+          Predicate, Visited> {
+ public:
+  using base_type =
+      csr_traversal<Container, csr_pre_order_traversal, Predicate, Visited>;
+  using typename base_type::graph_type;
+  using typename base_type::predicate_type;
+  using typename base_type::size_type;
+
+  csr_pre_order_traversal() = default;
+  csr_pre_order_traversal(const graph_type& graph, size_type root,
+                          predicate_type predicate = predicate_type(),
+                          size_type max_depth = base_type::unlimited);
+
+  bool next();
+
+ private:
+  friend base_type;
+
+  copy_on_write<std::vector<std::pair<size_type, size_type>>> to_visit_;
+};
+
+/** Post-order traversal of a csr_graph, visiting every child of a vertex,
+ * in link order, before the vertex itself */
+template <typename Container,
+          typename Predicate = predicate_function<Container>,
+          typename Visited = no_visited_set>
+class csr_post_order_traversal
+    : public csr_traversal<
+          Container, csr_post_order_traversal<Container, Predicate, Visited>,
+          Predicate, Visited> {
+ public:
+  using base_type =
+      csr_traversal<Container, csr_post_order_traversal, Predicate, Visited>;
+  using typename base_type::graph_type;
+  using typename base_type::predicate_type;
+  using typename base_type::size_type;
+
+  csr_post_order_traversal() = default;
+  csr_post_order_traversal(const graph_type& graph, size_type root,
+                           predicate_type predicate = predicate_type(),
+                           size_type max_depth = base_type::unlimited);
+
+  bool next();
+
+ private:
+  friend base_type;
+
+  copy_on_write<std::vector<std::pair<size_type, size_type>>> to_visit_;
+};
+
+/** In-order traversal of a csr_graph. The first link is the left subtree and
+ * any further links are visited, in order, after the vertex itself */
+template <typename Container,
+          typename Predicate = predicate_function<Container>,
+          typename Visited = no_visited_set>
+class csr_in_order_traversal
+    : public csr_traversal<
+          Container, csr_in_order_traversal<Container, Predicate, Visited>,
+          Predicate, Visited> {
+ public:
+  using base_type =
+      csr_traversal<Container, csr_in_order_traversal, Predicate, Visited>;
+  using typename base_type::graph_type;
+  using typename base_type::predicate_type;
+  using typename base_type::size_type;
+
+  csr_in_order_traversal() = default;
+  csr_in_order_traversal(const graph_type& graph, size_type root,
+                         predicate_type predicate = predicate_type(),
+                         size_type max_depth = base_type::unlimited);
+
+  bool next();
+
+ private:
+  friend base_type;
+
+  copy_on_write<std::vector<std::pair<size_type, size_type>>> to_visit_;
+};
+
+/** Breadth first traversal of a csr_graph, queueing each vertex with its
+ * depth */
+template <typename Container,
+          typename Predicate = predicate_function<Container>,
+          typename Visited = no_visited_set>
+class csr_breadth_first_traversal
+    : public csr_traversal<
+          Container, csr_breadth_first_traversal<Container, Predicate, Visited>,
+          Predicate, Visited> {
+ public:
+  using base_type =
+      csr_traversal<Container, csr_breadth_first_traversal, Predicate, Visited>;
+  using base_type::base_type;
+  using typename base_type::graph_type;
+  using typename base_type::predicate_type;
+  using typename base_type::size_type;
+
+  bool next();
+
+ private:
+  friend base_type;
+
+  copy_on_write<std::deque<std::pair<size_type, size_type>>> to_visit_;
+};
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+csr_traversal<Container, Impl, Predicate, Visited>::csr_traversal(
+    const graph_type& graph, size_type root, predicate_type predicate,
+    size_type max_depth)
+    : graph_(&graph),
+      root_(root),
+      position_(root),
+      max_depth_(max_depth),
+      predicate_(std::move(predicate)) {
+  if (root != npos) {
+    visited_.mutate().insert(root);
+  }
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+const typename csr_traversal<Container, Impl, Predicate, Visited>::graph_type&
+csr_traversal<Container, Impl, Predicate, Visited>::graph() const {
+  return *graph_;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+typename csr_traversal<Container, Impl, Predicate, Visited>::size_type
+csr_traversal<Container, Impl, Predicate, Visited>::root() const {
+  return root_;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+typename csr_traversal<Container, Impl, Predicate, Visited>::size_type
+csr_traversal<Container, Impl, Predicate, Visited>::position() const {
+  return position_;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+typename csr_traversal<Container, Impl, Predicate, Visited>::size_type
+csr_traversal<Container, Impl, Predicate, Visited>::depth() const {
+  return depth_;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+typename csr_traversal<Container, Impl, Predicate, Visited>::size_type
+csr_traversal<Container, Impl, Predicate, Visited>::max_depth() const {
+  return max_depth_;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+void csr_traversal<Container, Impl, Predicate, Visited>::position(
+    size_type value) {
+  position_ = value;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+void csr_traversal<Container, Impl, Predicate, Visited>::position(
+    size_type value, size_type depth) {
+  position_ = value;
+  depth_ = depth;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+const typename csr_traversal<Container, Impl, Predicate,
+                             Visited>::predicate_type&
+csr_traversal<Container, Impl, Predicate, Visited>::predicate() const {
+  return predicate_.get();
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+bool csr_traversal<Container, Impl, Predicate, Visited>::is_traversable(
+    size_type source, size_type target) {
+  if (target == npos) {
+    return false;
+  }
+  if constexpr (is_unconditional_v<Container, Predicate>) {
+    (void)source;
+  } else {
+    auto e = edge_type(graph_->key(source), graph_->key(target));
+    if constexpr (std::is_same_v<Predicate, predicate_function<Container>>) {
+      if (predicate_.get() && !predicate_.mutate()(e)) {
+        return false;
+      }
+    } else if constexpr (is_shareable_predicate_v<Container, Predicate>) {
+      if (!predicate_.get()(e)) {
+        return false;
+      }
+    } else if (!predicate_.mutate()(e)) {
+      return false;
+    }
+  }
+  if constexpr (std::is_same_v<Visited, no_visited_set>) {
+    return true;
+  } else {
+    return visited_.mutate().insert(target);
+  }
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+Impl csr_traversal<Container, Impl, Predicate, Visited>::begin() const {
+  return Impl(*graph_, root_, predicate_.get(), max_depth_);
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+Impl csr_traversal<Container, Impl, Predicate, Visited>::end() const {
+  auto result = static_cast<const Impl&>(*this);
+  result.position(npos, 0);
+  result.to_visit_ = decltype(result.to_visit_)();
+  result.visited_ = copy_on_write<visited_type>();
+  if constexpr (!is_shareable_predicate_v<Container, Predicate>) {
+    result.predicate_ = copy_on_write<predicate_type>(predicate());
+  }
+  return result;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+Impl& csr_traversal<Container, Impl, Predicate, Visited>::operator++() {
+  auto pImpl = static_cast<Impl*>(this);
+  if (!pImpl->next()) {
+    position(npos, 0);
+  }
+  return *pImpl;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+Impl csr_traversal<Container, Impl, Predicate, Visited>::operator++(int dummy) {
+  (void)dummy;
+  auto pImpl = static_cast<Impl*>(this);
+  auto copy = *pImpl;
+  // the copy is returned for reading, so it gives up the visited set rather
+  // than have the advance below clone it
+  copy.visited_ = copy_on_write<visited_type>();
+  ++*this;
+  return copy;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+typename csr_traversal<Container, Impl, Predicate, Visited>::const_reference
+    csr_traversal<Container, Impl, Predicate, Visited>::operator*() const {
+  return (*graph_)[position_];
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+typename csr_traversal<Container, Impl, Predicate, Visited>::const_pointer
+    csr_traversal<Container, Impl, Predicate, Visited>::operator->() const {
+  return &(*graph_)[position_];
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+bool csr_traversal<Container, Impl, Predicate, Visited>::operator==(
+    const self_type& rhs) const {
+  return position_ == rhs.position_ && root_ == rhs.root_;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+bool csr_traversal<Container, Impl, Predicate, Visited>::operator!=(
+    const self_type& rhs) const {
+  return !(*this == rhs);
+}
+
+template <typename Container, typename Predicate, typename Visited>
+csr_pre_order_traversal<Container, Predicate, Visited>::csr_pre_order_traversal(
+    const graph_type& graph, size_type root, predicate_type predicate,
+    size_type max_depth)
+    : base_type(graph, root, std::move(predicate), max_depth) {
+  if (root != base_type::npos) {
+    to_visit_.mutate().emplace_back(root, 0);
+  }
+}
+
+template <typename Container, typename Predicate, typename Visited>
+bool csr_pre_order_traversal<Container, Predicate, Visited>::next() {
+  auto& to_visit = to_visit_.mutate();
+  while (!to_visit.empty()) {
+    auto& [source, cursor] = to_visit.back();
+    auto children = base_type::graph().children(source);
+    if (cursor == children.size() ||
+        to_visit.size() > base_type::max_depth()) {
+      to_visit.pop_back();
+      continue;
+    }
+    auto target = children[cursor++];
+    if (base_type::is_traversable(source, target)) {
+      to_visit.emplace_back(target, 0);
+      base_type::position(target, to_visit.size() - 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename Container, typename Predicate, typename Visited>
+csr_post_order_traversal<Container, Predicate,
+                         Visited>::csr_post_order_traversal(
+    const graph_type& graph, size_type root, predicate_type predicate,
+    size_type max_depth)
+    : base_type(graph, root, std::move(predicate), max_depth) {
+  if (root != base_type::npos) {
+    to_visit_.mutate().emplace_back(root, 0);
+    next();
+  }
+}
+
+template <typename Container, typename Predicate, typename Visited>
+bool csr_post_order_traversal<Container, Predicate, Visited>::next() {
+  auto& to_visit = to_visit_.mutate();
+  while (!to_visit.empty()) {
+    auto& [source, cursor] = to_visit.back();
+    auto children = base_type::graph().children(source);
+    if (cursor == children.size() ||
+        to_visit.size() > base_type::max_depth()) {  // all children visited
+      base_type::position(source, to_visit.size() - 1);
+      to_visit.pop_back();
+      return true;
+    }
+    auto target = children[cursor++];
+    if (base_type::is_traversable(source, target)) {
+      to_visit.emplace_back(target, 0);
+    }
+  }
+  return false;
+}
+
+template <typename Container, typename Predicate, typename Visited>
+csr_in_order_traversal<Container, Predicate, Visited>::csr_in_order_traversal(
+    const graph_type& graph, size_type root, predicate_type predicate,
+    size_type max_depth)
+    : base_type(graph, root, std::move(predicate), max_depth) {
+  if (root != base_type::npos) {
+    to_visit_.mutate().emplace_back(root, 0);
+    next();
+  }
+}
+
+template <typename Container, typename Predicate, typename Visited>
+bool csr_in_order_traversal<Container, Predicate, Visited>::next() {
+  auto& to_visit = to_visit_.mutate();
+  // a vertex with n > 0 links visits child 0, itself, then children 1..n-1
+  while (!to_visit.empty()) {
+    auto& [source, cursor] = to_visit.back();
+    auto children = base_type::graph().children(source);
+    auto leaf = children.empty() || to_visit.size() > base_type::max_depth();
+    auto steps = leaf ? size_type(1) : children.size() + 1;
+    if (cursor == steps) {
+      to_visit.pop_back();
+      continue;
+    }
+    auto step = cursor++;
+    if (leaf || step == 1) {
+      base_type::position(source, to_visit.size() - 1);
+      return true;
+    }
+    auto target = children[step == 0 ? 0 : step - 1];
+    if (base_type::is_traversable(source, target)) {
+      to_visit.emplace_back(target, 0);
+    }
+  }
+  return false;
+}
+
+template <typename Container, typename Predicate, typename Visited>
+bool csr_breadth_first_traversal<Container, Predicate, Visited>::next() {
+  auto& to_visit = to_visit_.mutate();
+  auto source = base_type::position();
+  auto depth = base_type::depth();
+  if (source != base_type::npos && depth < base_type::max_depth()) {
+    for (auto target : base_type::graph().children(source)) {
+      if (base_type::is_traversable(source, target)) {
+        to_visit.emplace_back(target, depth + 1);
+      }
+    }
+  }
+  if (to_visit.empty()) {
+    return false;
+  }
+  base_type::position(to_visit.front().first, to_visit.front().second);
+  to_visit.pop_front();
+  return true;
+}
+
+}  // namespace vertex
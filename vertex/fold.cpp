@@ -0,0 +1 @@
+#include <vertex/fold.h>
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <vertex/parallel_for.h>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vertex {
+
+/** Tuning for fold */
+struct fold_options {
+  /** Number of threads which combine independent subtrees. With one, every
+   * call is made on the calling thread in post-order */
+  std::size_t threads = 1;
+
+  /** Minimum number of vertices given to each thread */
+  std::size_t grain = 256;
+};
+
+/** The result of folding with LeafFunction over a Container */
+template <typename Container, typename LeafFunction>
+using fold_result_t = std::decay_t<
+    std::invoke_result_t<LeafFunction&, const typename Container::value_type&>>;
+
+/** Computes an aggregate of the subgraph below root, such as its size, byte
+ * total or hash, bottom-up.
+ *
+ * The result of a vertex is leaf(vertex), combined with the result of each
+ * child in link order as acc = combine(std::move(acc), child_result). Nodes
+ * may have any number of links; missing children are skipped. Results are
+ * memoized per vertex, so a subtree shared by several parents is computed
+ * once. A link back to a vertex on the path from root, which would close a
+ * cycle, is ignored.
+ *
+ * Given more than one thread, vertices of equal height, whose subtrees are
+ * independent, are combined concurrently, so leaf and combine must then be
+ * safe to call from several threads at once. The Container must not move
+ * its elements meanwhile, e.g. std::map or stable_hash_map.
+ * @return the result of root, or nothing if root is end() */
+template <typename Container, typename LeafFunction, typename CombineFunction>
+std::optional<fold_result_t<Container, LeafFunction>> fold(
+    const Container& vertices, typename Container::const_iterator root,
+    LeafFunction leaf, CombineFunction combine,
+    const fold_options& options = fold_options());
+
+template <typename Container, typename LeafFunction, typename CombineFunction>
+std::optional<fold_result_t<Container, LeafFunction>> fold(
+    const Container& vertices, typename Container::const_iterator root,
+    LeafFunction leaf, CombineFunction combine, const fold_options& options) {
+  using size_type = std::size_t;
+  using vertex_iterator = typename Container::const_iterator;
+  using link_iterator = decltype(root->second.begin());
+  constexpr auto npos = std::numeric_limits<size_type>::max();
+  if (root == vertices.end()) {
+    return std::nullopt;
+  }
+
+  // number the vertices in post-order, recording the children of each as
+  // ranges of offsets, so that every child precedes its parents
+  struct frame {
+    vertex_iterator vertex;
+    link_iterator next;
+    size_type mark;  // start of this vertex's children in found
+  };
+  auto index = std::unordered_map<const void*, size_type>();  // npos: on path
+  auto order = std::vector<vertex_iterator>();
+  auto offsets = std::vector<size_type>{0};
+  auto children = std::vector<size_type>();
+  auto found = std::vector<size_type>();  // children of the frames on path
+  auto to_visit = std::vector<frame>();
+  index.emplace(&*root, npos);
+  to_visit.push_back(frame{root, root->second.begin(), 0});
+  while (!to_visit.empty()) {
+    auto& top = to_visit.back();
+    if (top.next == top.vertex->second.end()) {
+      auto position = order.size();
+      index[&*top.vertex] = position;
+      order.push_back(top.vertex);
+      children.insert(children.end(), found.begin() + top.mark, found.end());
+      offsets.push_back(children.size());
+      found.resize(top.mark);
+      to_visit.pop_back();
+      found.push_back(position);  // a child of the new top, if any
+      continue;
+    }
+    auto child = vertices.find(*top.next++);
+    if (child == vertices.end()) {
+      continue;
+    }
+    auto [it, inserted] = index.emplace(&*child, npos);
+    if (inserted) {
+      to_visit.push_back(frame{child, child->second.begin(), found.size()});
+    } else if (it->second != npos) {  // already computed
+      found.push_back(it->second);
+    }
+  }
+
+  using result_type = fold_result_t<Container, LeafFunction>;
+  auto results = std::vector<std::optional<result_type>>(order.size());
+  auto compute = [&](size_type i) {
+    auto acc = result_type(leaf(*order[i]));
+    for (auto c = offsets[i]; c != offsets[i + 1]; ++c) {
+      acc = combine(std::move(acc),
+                    static_cast<const result_type&>(*results[children[c]]));
+    }
+    results[i] = std::move(acc);
+  };
+
+  if (options.threads <= 1) {
+    for (size_type i = 0; i < order.size(); ++i) {
+      compute(i);
+    }
+  } else {  // group the vertices by height, each group depending on the last
+    auto heights = std::vector<size_type>(order.size(), 0);
+    auto levels = std::vector<std::vector<size_type>>();
+    for (size_type i = 0; i < order.size(); ++i) {
+      for (auto c = offsets[i]; c != offsets[i + 1]; ++c) {
+        heights[i] = std::max(heights[i], heights[children[c]] + 1);
+      }
+      if (heights[i] == levels.size()) {
+        levels.emplace_back();
+      }
+      levels[heights[i]].push_back(i);
+    }
+    for (const auto& level : levels) {
+      parallel_for(
+          level.size(), options.threads,
+          [&](size_type first, size_type last, size_type /*chunk*/) {
+            for (; first != last; ++first) {
+              compute(level[first]);
+            }
+          },
+          options.grain);
+    }
+  }
+  return std::move(results.back());  // root is numbered last
+}
+
+}  // namespace vertex
@@ -0,0 +1,175 @@
+#include <vertex/glob_traversal.h>
+
+namespace vertex {
+
+namespace {
+
+/** Matches c against the class which opens at pattern[i], e.g. [!a-z]
+ * @return the position after the class, or npos if it is not closed */
+std::size_t match_class(std::string_view pattern, std::size_t i, char c,
+                        bool& matched) {
+  ++i;  // past '['
+  auto negated = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+  if (negated) {
+    ++i;
+  }
+  matched = false;
+  for (auto first = i; i < pattern.size(); ++i) {
+    if (pattern[i] == ']' && i != first) {
+      matched = matched != negated;
+      return i + 1;
+    }
+    if (i + 2 < pattern.size() && pattern[i + 1] == '-' &&
+        pattern[i + 2] != ']') {
+      matched = matched || (pattern[i] <= c && c <= pattern[i + 2]);
+      i += 2;
+    } else {
+      matched = matched || pattern[i] == c;
+    }
+  }
+  return std::string_view::npos;
+}
+
+/** Matches the whole of text against a wildcard segment. On a mismatch, the
+ * last '*' seen is retried one character further along text */
+bool match_wildcard(std::string_view pattern, std::string_view text) {
+  constexpr auto npos = std::string_view::npos;
+  auto p = std::size_t(0);
+  auto t = std::size_t(0);
+  auto star = npos;    // position after the last '*'
+  auto resume = npos;  // text position that '*' matched up to
+  while (t < text.size()) {
+    if (p < pattern.size() && pattern[p] == '*') {
+      star = ++p;
+      resume = t;
+      continue;
+    }
+    if (p < pattern.size()) {
+      auto matched = pattern[p] == '?' || pattern[p] == text[t];
+      auto next = p + 1;
+      if (pattern[p] == '[') {
+        auto end = match_class(pattern, p, text[t], matched);
+        if (end != npos) {
+          next = end;
+        } else {  // an unclosed '[' is an ordinary character
+          matched = text[t] == '[';
+        }
+      }
+      if (matched) {
+        p = next;
+        ++t;
+        continue;
+      }
+    }
+    if (star == npos) {
+      return false;
+    }
+    p = star;
+    t = ++resume;
+  }
+  while (p < pattern.size() && pattern[p] == '*') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+
+}  // namespace
+
+glob_pattern::glob_pattern(std::string_view pattern) {
+  while (!pattern.empty()) {
+    auto end = pattern.find('/');
+    auto text = pattern.substr(0, end);
+    pattern.remove_prefix(end == std::string_view::npos ? pattern.size()
+                                                        : end + 1);
+    if (text.empty()) {
+      continue;
+    }
+    if (text.substr(0, 2) == "**") {
+      segments_.push_back(segment{kind::globstar, "**"});
+      if (text.size() == 2) {
+        continue;
+      }
+      text.remove_prefix(1);  // '**.log' is '**' then '*.log'
+    }
+    if (text == "*") {
+      segments_.push_back(segment{kind::any, std::string(text)});
+    } else if (text.find_first_of("*?[") != std::string_view::npos) {
+      segments_.push_back(segment{kind::wildcard, std::string(text)});
+    } else {
+      segments_.push_back(segment{kind::literal, std::string(text)});
+    }
+  }
+}
+
+glob_pattern::state_set glob_pattern::start() const {
+  auto result = state_set{0};
+  close(result);
+  return result;
+}
+
+glob_pattern::state_set glob_pattern::next(const state_set& states,
+                                           std::string_view segment) const {
+  auto result = state_set();
+  for (auto i : states) {
+    if (i == segments_.size()) {
+      continue;
+    }
+    if (segments_[i].type == kind::globstar) {
+      result.push_back(i);  // '**' consumes the segment and remains
+    } else if (matches(segments_[i], segment)) {
+      result.push_back(i + 1);
+    }
+  }
+  close(result);
+  return result;
+}
+
+bool glob_pattern::accepts(const state_set& states) const {
+  return std::binary_search(states.begin(), states.end(), segments_.size());
+}
+
+bool glob_pattern::literals(const state_set& states,
+                            std::vector<std::string_view>& literals) const {
+  literals.clear();
+  for (auto i : states) {
+    if (i == segments_.size()) {
+      continue;
+    }
+    if (segments_[i].type != kind::literal) {
+      literals.clear();
+      return false;
+    }
+    literals.push_back(segments_[i].text);
+  }
+  std::sort(literals.begin(), literals.end());
+  literals.erase(std::unique(literals.begin(), literals.end()),
+                 literals.end());
+  return true;
+}
+
+void glob_pattern::close(state_set& states) const {
+  for (std::size_t k = 0; k < states.size(); ++k) {
+    auto i = states[k];
+    if (i != segments_.size() && segments_[i].type == kind::globstar) {
+      states.push_back(i + 1);  // '**' may match no segments
+    }
+  }
+  std::sort(states.begin(), states.end());
+  states.erase(std::unique(states.begin(), states.end()), states.end());
+}
+
+bool glob_pattern::matches(const segment& pattern,
+                           std::string_view text) const {
+  switch (pattern.type) {
+    case kind::literal:
+      return text == pattern.text;
+    case kind::any:
+    case kind::globstar:
+      return true;
+    case kind::wildcard:
+      return match_wildcard(pattern.text, text);
+  }
+  return false;
+}
+
+}  // namespace vertex
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <vertex/path.h>
+#include <vertex/traversal.h>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace vertex {
+
+/** A glob pattern over the segments of a path, such as the segments 'home',
+ * 'bob' and '**.log', which match the log files anywhere below /home/bob.
+ *
+ * The pattern is split on '/', and each segment is one of
+ * - a literal, which matches itself;
+ * - '*', which matches any one segment;
+ * - '**', which matches any number of segments, including none;
+ * - a wildcard made of characters, '?' for any one character, '*' for any
+ *   run of characters, and classes such as [abc], [a-z] or [!0-9].
+ * A segment which starts with '**' followed by a wildcard, e.g. '**.log',
+ * matches any number of segments and then one matching the wildcard.
+ *
+ * The pattern is compiled to a nondeterministic automaton, whose states are
+ * positions in the segments. A state_set holds the states reached along a
+ * path, so that the matching of a path is extended one segment at a time as
+ * a traversal descends. An empty state_set can match nothing below. */
+class glob_pattern {
+ public:
+  using size_type = std::size_t;
+  using state_set = std::vector<size_type>;
+
+  explicit glob_pattern(std::string_view pattern);
+
+  /** Returns the states of the empty path */
+  state_set start() const;
+
+  /** Returns the states reached from states by appending segment */
+  state_set next(const state_set& states, std::string_view segment) const;
+
+  /** Returns true if a path which reaches states matches the pattern */
+  bool accepts(const state_set& states) const;
+
+  /** Collects the segments which may follow a path that reaches states, if
+   * each is a literal, so that a traversal may look them up rather than
+   * test every link.
+   * @return false, leaving literals empty, if some state expects a wildcard
+   */
+  bool literals(const state_set& states,
+                std::vector<std::string_view>& literals) const;
+
+  /** Returns true if the whole of path matches the pattern */
+  template <typename Path>
+  bool matches(const Path& path) const;
+
+ private:
+  enum class kind { literal, any, globstar, wildcard };
+
+  struct segment {
+    kind type;
+    std::string text;
+  };
+
+  /** Sorts states, adding those reached by skipping a '**' */
+  void close(state_set& states) const;
+
+  bool matches(const segment& pattern, std::string_view text) const;
+
+  std::vector<segment> segments_;
+};
+
+/** Pre-order traversal of the paths below root which match a glob_pattern,
+ * visiting only the vertices at their ends.
+ *
+ * The pattern acts as the predicate of the traversal: each frame holds the
+ * states of the path to its vertex, and a link is only followed if it leads
+ * to a state from which the pattern can still match, so that subtrees which
+ * cannot match are never entered. Where the pattern expects only literal
+ * segments, their links are found directly instead of scanning the links of
+ * the vertex. The Predicate is tested on each edge as well.
+ *
+ * The segments of the current path are held as pointers to the keys of the
+ * vertices along it, and returned by path(). The root, at the start, is
+ * reached by the empty path and is not tested. The key_type of Container
+ * must convert to std::string_view and be constructible from one. */
+template <typename Container, typename Predicate = unconditional<Container>,
+          typename Visited = no_visited_set>
+class glob_traversal
+    : public traversal<Container,
+                       glob_traversal<Container, Predicate, Visited>,
+                       Predicate, Visited> {
+ public:
+  using base_type = traversal<Container, glob_traversal, Predicate, Visited>;
+  using base_type::is_traversable;
+  using base_type::position;
+  using base_type::vertices;
+  using typename base_type::key_type;
+  using typename base_type::predicate_type;
+  using typename base_type::size_type;
+
+  glob_traversal() = default;
+
+  glob_traversal(
+      const Container& vertices, typename Container::const_iterator root,
+      glob_pattern pattern,
+      predicate_type predicate = typename base_type::unconditional_traversal(),
+      size_type max_depth = base_type::unlimited);
+
+  const glob_pattern& pattern() const;
+
+  /** Returns the path from the root to the current position */
+  path_view<Container> path() const;
+
+  glob_traversal begin() const;
+
+  bool next();
+
+ private:
+  friend base_type;
+
+  using vertex_iterator = typename base_type::vertex_iterator;
+  using link_iterator =
+      typename Container::mapped_type::container_type::const_iterator;
+  using state_set = glob_pattern::state_set;
+
+  struct frame {
+    vertex_iterator vertex;
+    state_set states;  // of the path to vertex
+    bool is_literal;   // children are looked up from literals
+    link_iterator next;  // the next child link to test, unless is_literal
+    std::vector<std::string_view> literals;  // children left to look up
+  };
+
+  struct stack {
+    std::vector<frame> frames;
+    std::vector<const key_type*> path;  // the keys of frames but the first
+  };
+
+  void push(stack& to_visit, const vertex_iterator& vertex,
+            state_set states);
+
+  /** Finds the next link of top which the pattern can follow
+   * @return false if top has no more such links */
+  bool next_child(frame& top, key_type& key, state_set& states);
+
+  copy_on_write<glob_pattern> pattern_;
+  copy_on_write<stack> to_visit_;
+};
+
+template <typename Path>
+bool glob_pattern::matches(const Path& path) const {
+  auto states = start();
+  for (const auto& segment : path) {
+    if (states.empty()) {
+      return false;
+    }
+    states = next(states, std::string_view(segment));
+  }
+  return accepts(states);
+}
+
+template <typename Container, typename Predicate, typename Visited>
+glob_traversal<Container, Predicate, Visited>::glob_traversal(
+    const Container& vertices, typename Container::const_iterator root,
+    glob_pattern pattern, predicate_type predicate, size_type max_depth)
+    : base_type(vertices, root, std::move(predicate), max_depth),
+      pattern_(std::move(pattern)) {
+  if (position() != vertices.end()) {
+    push(to_visit_.mutate(), position(), pattern_.get().start());
+  }
+}
+
+template <typename Container, typename Predicate, typename Visited>
+const glob_pattern& glob_traversal<Container, Predicate, Visited>::pattern()
+    const {
+  return pattern_.get();
+}
+
+template <typename Container, typename Predicate, typename Visited>
+path_view<Container> glob_traversal<Container, Predicate, Visited>::path()
+    const {
+  if (!to_visit_ || position() == vertices().end()) {
+    return path_view<Container>();
+  }
+  const auto& path = to_visit_.get().path;
+  return path_view<Container>(path.data(), path.size());
+}
+
+template <typename Container, typename Predicate, typename Visited>
+glob_traversal<Container, Predicate, Visited>
+glob_traversal<Container, Predicate, Visited>::begin() const {
+  return glob_traversal(vertices(), base_type::root(), pattern(),
+                        base_type::predicate(), base_type::max_depth());
+}
+
+template <typename Container, typename Predicate, typename Visited>
+void glob_traversal<Container, Predicate, Visited>::push(
+    stack& to_visit, const vertex_iterator& vertex, state_set states) {
+  if (!to_visit.frames.empty()) {
+    to_visit.path.push_back(&vertex->first);
+  }
+  auto links = vertex->second.begin();
+  to_visit.frames.push_back(frame{vertex, std::move(states), false, links, {}});
+  auto& top = to_visit.frames.back();
+  top.is_literal = pattern().literals(top.states, top.literals);
+  std::reverse(top.literals.begin(), top.literals.end());  // taken from back
+  base_type::position(vertex, to_visit.frames.size() - 1);
+}
+
+template <typename Container, typename Predicate, typename Visited>
+bool glob_traversal<Container, Predicate, Visited>::next_child(
+    frame& top, key_type& key, state_set& states) {
+  const auto& links = top.vertex->second;
+  if (top.is_literal) {  // look up the expected segments in turn
+    while (!top.literals.empty()) {
+      key = key_type(top.literals.back());
+      top.literals.pop_back();
+      if (links.find(key) != links.end()) {
+        states = pattern().next(top.states, std::string_view(key));
+        return true;
+      }
+    }
+    return false;
+  }
+  for (auto end = links.end(); top.next != end;) {
+    const auto& link = *top.next++;
+    states = pattern().next(top.states, std::string_view(link));
+    if (!states.empty()) {
+      key = link;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename Container, typename Predicate, typename Visited>
+bool glob_traversal<Container, Predicate, Visited>::next() {
+  auto& to_visit = to_visit_.mutate();
+  auto key = key_type();
+  auto states = state_set();
+  while (!to_visit.frames.empty()) {
+    auto& top = to_visit.frames.back();
+    if (to_visit.frames.size() > base_type::max_depth() ||
+        !next_child(top, key, states)) {
+      to_visit.frames.pop_back();
+      if (!to_visit.path.empty()) {
+        to_visit.path.pop_back();
+      }
+      continue;
+    }
+    auto child = vertices().find(key);
+    if (child == vertices().end() || !is_traversable(top.vertex->first, key) ||
+        !base_type::enter(child)) {
+      continue;
+    }
+    push(to_visit, child, std::move(states));
+    if (pattern().accepts(to_visit.frames.back().states)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace vertex
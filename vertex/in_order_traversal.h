@@ -4,71 +4,97 @@
 #include <stack>
 
 namespace vertex {
-template <typename Container>
+/** In-order traversal of binary vertices. Each stacked edge carries the
+ * depth of its target, and children below max_depth are not pushed */
+template <typename Container,
+          typename Predicate = predicate_function<Container>,
+          typename Visited = no_visited_set>
 class in_order_traversal
-    : public traversal<Container, in_order_traversal<Container>> {
+    : public traversal<Container,
+                       in_order_traversal<Container, Predicate, Visited>,
+                       Predicate, Visited> {
  public:
-  using base_type = traversal<Container, in_order_traversal<Container>>;
+  using base_type =
+      traversal<Container, in_order_traversal, Predicate, Visited>;
   using base_type::is_traversable;
   using base_type::position;
   using base_type::root;
   using base_type::vertices;
   using typename base_type::predicate_type;
+  using typename base_type::size_type;
 
   in_order_traversal(
       const Container& vertices, typename Container::const_iterator root,
-      predicate_type predicate = typename base_type::unconditional_traversal());
+      predicate_type predicate = typename base_type::unconditional_traversal(),
+      size_type max_depth = base_type::unlimited);
   bool next();
 
  private:
-  std::stack<typename base_type::edge_type> to_visit_;
+  friend base_type;
+
+  using entry = std::pair<typename base_type::edge_type, size_type>;
+
+  copy_on_write<std::stack<entry>> to_visit_;
   typename base_type::vertex_iterator next_position_;
+  size_type next_depth_ = 0;
 };
 
-template <typename Container>
-in_order_traversal<Container>::in_order_traversal(
+template <typename Container, typename Predicate, typename Visited>
+in_order_traversal<Container, Predicate, Visited>::in_order_traversal(
     const Container& vertices, typename Container::const_iterator root,
-    typename in_order_traversal<Container>::predicate_type predicate)
-    : base_type(vertices, root, predicate), next_position_(position()) {
+    predicate_type predicate, size_type max_depth)
+    : base_type(vertices, root, predicate, max_depth),
+      next_position_(position()) {
   if (position() != base_type::vertices().end()) {
     auto e = edge<Container>::root(position()->first);
-    to_visit_.push(e);
+    to_visit_.mutate().emplace(e, 0);
     next();
   }
 }
 
-template <typename Container>
-bool in_order_traversal<Container>::next() {
-  if (to_visit_.empty()) {
+template <typename Container, typename Predicate, typename Visited>
+bool in_order_traversal<Container, Predicate, Visited>::next() {
+  auto& to_visit = to_visit_.mutate();
+  if (to_visit.empty()) {
     return false;
   }
   auto child = next_position_;
-  while (child != vertices().end() && !child->second.empty()) {
+  auto depth = next_depth_;
+  while (child != vertices().end() && !child->second.empty() &&
+         depth < base_type::max_depth()) {
     // traversal to bottom of left branch
+    ++depth;
     auto next_child = vertices().find(*child->second.begin());
     if (next_child != vertices().end()) {
       auto e = edge<Container>(child->first, next_child->first);
       if (is_traversable(e)) {
-        to_visit_.push(e);
+        if (!base_type::enter(next_child)) {
+          break;  // entered before, along with its left branch
+        }
+        to_visit.emplace(e, depth);
       }
     }
     child = next_child;
   }
-  auto e = to_visit_.top();
-  to_visit_.pop();
+  auto e = to_visit.top().first;
+  depth = to_visit.top().second;
+  to_visit.pop();
   child = vertices().find(e.target());
   if (child != vertices().end()) {  // next child on stack is not null
     next_position_ = child;
+    next_depth_ = depth;
   }
-  base_type::position(next_position_);
-  if (next_position_->second.size() > 1) {  // traverse right branch
+  base_type::position(next_position_, next_depth_);
+  if (next_position_->second.size() > 1 &&
+      next_depth_ < base_type::max_depth()) {  // traverse right branch
     auto link = *(++next_position_->second.begin());
     child = vertices().find(link);
     e = edge<Container>(next_position_->first, link);
-    if (child != vertices().end() &&
-        is_traversable(e)) {  // don't move to right child if null
-      to_visit_.push(e);
+    if (child != vertices().end() && is_traversable(e) &&
+        base_type::enter(child)) {  // don't move to right child if null
+      to_visit.emplace(e, next_depth_ + 1);
       next_position_ = child;
+      ++next_depth_;
     }
   }
   return true;
@@ -29,6 +29,10 @@ class iterator_recorder {
   iterator_recorder();
   explicit iterator_recorder(Iterator it);
 
+  /** Positions the recorder at it, as though history had already been
+   * recorded, so that operator-- rewinds through history */
+  iterator_recorder(Iterator it, std::vector<value_type> history);
+
  public: /** Operators */
   iterator_recorder& operator++();
 
@@ -61,6 +65,13 @@ iterator_recorder<Iterator>::iterator_recorder(Iterator it)
       it_(std::move(it)),
       index_(0) {}
 
+template <typename Iterator>
+iterator_recorder<Iterator>::iterator_recorder(Iterator it,
+                                               std::vector<value_type> history)
+    : values_(std::make_shared<std::vector<value_type>>(std::move(history))),
+      it_(std::move(it)),
+      index_(values_->size()) {}
+
 template <typename Iterator>
 void iterator_recorder<Iterator>::evaluate() {
   if (index_ >= values_->size()) {
@@ -1,58 +1,131 @@
 #pragma once
+#include <vertex/atomic_bitmap.h>
 #include <vertex/node.h>
+#include <vertex/parallel_for.h>
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
 #include <queue>
 #include <set>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace vertex {
 
+/** EdgeMap placeholder for a managed_container which keeps intrusive
+ * reference counts in its vertices instead of recording parent edges */
+template <typename Key>
+struct no_edge_map {
+  using key_type = Key;
+  using value_type = std::pair<const Key, Key>;
+};
+
+/** Detects Container::reserve, to size storage ahead of a bulk insert */
+template <typename Container, typename = void>
+struct has_reserve : std::false_type {};
+
+template <typename Container>
+struct has_reserve<Container,
+                   std::void_t<decltype(std::declval<Container&>().reserve(
+                       std::declval<typename Container::size_type>()))>>
+    : std::true_type {};
+
+/** Detects Container::quick_erase, which erases without finding the next
+ * element */
+template <typename Container, typename = void>
+struct has_quick_erase : std::false_type {};
+
+template <typename Container>
+struct has_quick_erase<
+    Container, std::void_t<decltype(std::declval<Container&>().quick_erase(
+                   std::declval<typename Container::const_iterator>()))>>
+    : std::true_type {};
+
+/** How a managed_container reclaims vertices which become unreferenced */
+enum class reclamation_mode {
+  immediate, /** erase the whole unreferenced subtree within erase() */
+  deferred   /** mark vertices dead, reclaiming them in collect() */
+};
+
 /** ManagedContainer is a specialised AssociativeArray with reference
  * counting to ensure unreferenced Node objects are deleted from storage.
  * Container is a map which stores Node objects by Key
  * EdgeMap is a multimap which stores Node parents as pairs of Edge objects
- * Container MUST NOT invalidate iterators on insertion or deletion
+ * Container MUST NOT invalidate iterators on insertion or deletion, e.g.
+ * std::map or stable_hash_map
+ *
+ * If EdgeMap is void, no parent edges are recorded. Container::mapped_type
+ * must then be a counted_node, whose intrusive count makes count() and the
+ * removal of an edge O(1).
+ *
+ * In reclamation_mode::deferred, erase() only marks a vertex dead. Dead
+ * vertices remain in storage, and visible to find(), until collect()
+ * reclaims them a bounded number at a time.
  */
-template <typename Container, typename EdgeMap>
+template <typename Container, typename EdgeMap = void>
 class managed_container {
  public:
+  using edge_map_type =
+      std::conditional_t<std::is_void_v<EdgeMap>,
+                         no_edge_map<typename Container::key_type>, EdgeMap>;
+
+  static constexpr bool is_intrusive = std::is_void_v<EdgeMap>;
+
   static_assert(std::is_same<typename Container::key_type,
-                             typename EdgeMap::key_type>::value,
+                             typename edge_map_type::key_type>::value,
                 "Container::key_type != EdgeMap::key_type");
-  static_assert(std::is_same<typename EdgeMap::key_type,
-                             typename EdgeMap::value_type::second_type>::value,
-                "EdgeMap::key_type != EdgeMap::value_type::second_type");
+  static_assert(
+      std::is_same<typename edge_map_type::key_type,
+                   typename edge_map_type::value_type::second_type>::value,
+      "EdgeMap::key_type != EdgeMap::value_type::second_type");
 
   using key_type = typename Container::key_type;
   using mapped_type = typename Container::mapped_type;
   using value_type = typename Container::value_type;
   using size_type = typename Container::size_type;
   using difference_type = typename Container::difference_type;
-  using key_compare = typename Container::key_compare;
   using reference = value_type&;
   using const_reference = const value_type&;
   using pointer = typename Container::pointer;
   using const_pointer = typename Container::const_pointer;
   using iterator = typename Container::iterator;
   using const_iterator = typename Container::const_iterator;
-  using reverse_iterator = typename Container::reverse_iterator;
-  using const_reverse_iterator = typename Container::const_reverse_iterator;
 
   explicit managed_container(Container vertices = Container(),
-                             EdgeMap edges = EdgeMap());
+                             edge_map_type edges = edge_map_type());
 
-  iterator begin() const;
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
   const_iterator cbegin() const;
-  iterator end() const;
   const_iterator cend() const;
 
+  /** Returns the number of stored vertices */
+  size_type size() const;
+
+  /** Returns the underlying vertex storage, e.g. to traverse it */
+  const Container& vertices() const;
+
   /** Insert a vertex, creating edges from all its children
    * Every child must exist */
   std::pair<iterator, bool> insert(const value_type& value);
 
+  /** Insert a range of vertices, creating edges from all their children.
+   * Every child must exist, either already or within the range. Of several
+   * values with the same key, only the first is inserted.
+   *
+   * The vertices, then their edges, are sorted by key and merged in order
+   * using hinted insertion, so that loading a snapshot takes close to linear
+   * time rather than one tree descent per vertex and per link.
+   * @return the number of vertices inserted */
+  template <typename InputIt>
+  size_type insert(InputIt first, InputIt last);
+
   /** Find the vertex stored under the given key */
   iterator find(const key_type& key);
 
@@ -61,46 +134,188 @@ class managed_container {
   iterator erase(iterator pos);
 
   /** Get reference count for vertex with given key */
-  size_type count(const key_type& key);
+  size_type count(const key_type& key) const;
+
+  /** Returns the child to parent index, holding a (child, parent) entry per
+   * link, e.g. to walk up with ancestor_traversal. Only maintained when
+   * EdgeMap is not void */
+  const edge_map_type& parents() const;
 
   /** Erase the whole forest */
   void clear();
 
+  /** Get the reclamation mode */
+  reclamation_mode reclamation() const;
+
+  /** Set the reclamation mode. Vertices already marked dead stay pending */
+  managed_container& reclamation(reclamation_mode value);
+
+  /** Get the number of dead vertices awaiting collection */
+  size_type garbage() const;
+
+  /** Reclaim at most budget dead vertices, releasing the edges to their
+   * children. Children left unreferenced are marked dead in turn, so each
+   * call does work proportional to budget and the fan-out of the vertices
+   * it reclaims.
+   * @return the number of vertices reclaimed */
+  size_type collect(
+      size_type budget = std::numeric_limits<size_type>::max());
+
+  /** Erase every vertex which is unreachable from the given root keys,
+   * regardless of its reference count, and rebuild the liveness of the
+   * rest from scratch, e.g. to recover from counts left inconsistent by a
+   * crash or a bulk import.
+   *
+   * Marking proceeds one level of the graph at a time: each frontier is
+   * partitioned across threads, which claim children in a shared atomic
+   * bitmap so that each reachable vertex is expanded exactly once. The
+   * reference counts, or the EdgeMap, are then recomputed from the links of
+   * the marked vertices alone, and the unmarked vertices are erased. Of the
+   * vertices awaiting collect(), the unreachable ones are swept; a root
+   * which was erased, and is still unreferenced, remains pending.
+   *
+   * The container must not be modified by other threads meanwhile.
+   * @return the number of vertices erased */
+  template <typename InputIt>
+  size_type mark_and_sweep(InputIt first_root, InputIt last_root,
+                           std::size_t threads = default_concurrency());
+
  private:
-  using edge_type = typename EdgeMap::value_type;
-  using edge_iterator = typename EdgeMap::iterator;
+  /** Record an edge from parent to child */
+  void acquire(const key_type& child, const key_type& parent);
 
-  /** Get an iterator to the edge matching the argument */
-  edge_iterator find(const edge_type& edge);
+  /** Remove an edge from parent to child, erasing any vertex which is left
+   * unreferenced along with its own edges */
+  void release(const key_type& child, const key_type& parent);
 
-  /** Remove the given vertex edge */
-  edge_iterator erase(const edge_type& edge);
+  /** Remove an edge, returning the remaining reference count of child */
+  size_type remove_edge(const key_type& child, const key_type& parent);
 
-  /** Remove the vertex edge at the given position.
-   * The given position must be valid. */
-  edge_iterator erase(edge_iterator pos);
+  /** Erase a vertex whose successor is not needed */
+  void discard(iterator pos);
 
   Container vertices_;
-  EdgeMap edges_;
+  edge_map_type edges_;
+  reclamation_mode reclamation_ = reclamation_mode::immediate;
+  std::set<key_type> dead_;
 };
 
 template <typename V, typename E>
-managed_container<V, E>::managed_container(V vertices, E edges)
+managed_container<V, E>::managed_container(V vertices, edge_map_type edges)
     : vertices_(std::move(vertices)), edges_(std::move(edges)) {}
 
+template <typename V, typename E>
+typename managed_container<V, E>::iterator managed_container<V, E>::begin() {
+  return vertices_.begin();
+}
+
+template <typename V, typename E>
+typename managed_container<V, E>::iterator managed_container<V, E>::end() {
+  return vertices_.end();
+}
+
+template <typename V, typename E>
+typename managed_container<V, E>::const_iterator
+managed_container<V, E>::begin() const {
+  return vertices_.begin();
+}
+
+template <typename V, typename E>
+typename managed_container<V, E>::const_iterator managed_container<V, E>::end()
+    const {
+  return vertices_.end();
+}
+
+template <typename V, typename E>
+typename managed_container<V, E>::const_iterator
+managed_container<V, E>::cbegin() const {
+  return begin();
+}
+
+template <typename V, typename E>
+typename managed_container<V, E>::const_iterator
+managed_container<V, E>::cend() const {
+  return end();
+}
+
+template <typename V, typename E>
+typename managed_container<V, E>::size_type managed_container<V, E>::size()
+    const {
+  return vertices_.size();
+}
+
+template <typename V, typename E>
+const V& managed_container<V, E>::vertices() const {
+  return vertices_;
+}
+
 template <typename V, typename E>
 std::pair<typename managed_container<V, E>::iterator, bool>
 managed_container<V, E>::insert(
     const typename managed_container<V, E>::value_type& value) {
   auto result = vertices_.insert(value); /** store the vertex */
-  for (const auto& link :
-       value.second
-           .children()) {  // add a edge from vertex to each of its children
-    edges_.insert(std::make_pair(link.key(), value.first));
+  dead_.erase(value.first);              // re-inserting revives a vertex
+  if (result.second) {  // add a edge from vertex to each of its children
+    for (const auto& link : result.first->second) {
+      acquire(link, value.first);
+    }
   }
   return result;
 }
 
+template <typename V, typename E>
+template <typename InputIt>
+typename managed_container<V, E>::size_type managed_container<V, E>::insert(
+    InputIt first, InputIt last) {
+  auto values = std::vector<std::pair<key_type, mapped_type>>(first, last);
+  auto by_key = [](const auto& lhs, const auto& rhs) {
+    return lhs.first < rhs.first;
+  };
+  if (!std::is_sorted(values.begin(), values.end(), by_key)) {
+    std::stable_sort(values.begin(), values.end(), by_key);
+  }
+  if constexpr (has_reserve<V>::value) {
+    vertices_.reserve(vertices_.size() + values.size());
+  }
+
+  size_type inserted = 0;
+  auto edges = std::vector<std::pair<key_type, key_type>>();  // child, parent
+  auto hint = vertices_.end();
+  for (auto& [key, mapped] : values) {
+    auto size = vertices_.size();
+    auto pos = vertices_.emplace_hint(hint, std::move(key), std::move(mapped));
+    hint = std::next(pos);
+    dead_.erase(pos->first);  // re-inserting revives a vertex
+    if (vertices_.size() != size) {
+      ++inserted;
+      for (const auto& link : pos->second) {
+        edges.emplace_back(link, pos->first);
+      }
+    }
+  }
+
+  std::sort(edges.begin(), edges.end());
+  if constexpr (is_intrusive) {
+    for (auto it = edges.begin(); it != edges.end();) {  // one find per child
+      auto child = vertices_.find(it->first);
+      assert(child != vertices_.end());
+      auto key = it->first;
+      for (; it != edges.end() && !(key < it->first); ++it) {
+        if (child != vertices_.end()) {
+          child->second.acquire();
+        }
+      }
+    }
+  } else {
+    auto edge_hint = edges_.end();
+    for (auto& [child, parent] : edges) {
+      edge_hint = std::next(
+          edges_.emplace_hint(edge_hint, std::move(child), std::move(parent)));
+    }
+  }
+  return inserted;
+}
+
 template <typename V, typename E>
 typename managed_container<V, E>::iterator managed_container<V, E>::find(
     const typename managed_container<V, E>::key_type& key) {
@@ -111,81 +326,270 @@ template <typename V, typename E>
 typename managed_container<V, E>::iterator managed_container<V, E>::erase(
     typename managed_container<V, E>::iterator pos) {
   auto result = pos;
-  const auto& edge = pos->first;
-  const auto& vertex = pos->second;
-  assert(vertex.self_edge() == edge);
-
-  if (edges_.count(edge) == 0) {  // Erase vertex iff no references to it
-    for (const auto& child :
-         vertex.edges_) {  // remove edges from vertex to its children
-      auto child_edge = edge_type(child, edge);
-      erase(child_edge);
+  if (count(pos->first) == 0) {  // Erase vertex iff no references to it
+    if (reclamation_ == reclamation_mode::deferred) {
+      dead_.insert(pos->first);
+      result = std::next(pos);
+    } else {
+      for (const auto& child : pos->second) {  // remove edges to children
+        release(child, pos->first);
+      }
+      result = vertices_.erase(pos);  // after the cascade, which may erase next
     }
-    result = vertices_.erase(pos);
   }
   return result;
 }
 
-/** TODO rewrite using traversal */
 template <typename V, typename E>
-typename managed_container<V, E>::edge_iterator managed_container<V, E>::erase(
-    typename managed_container<V, E>::edge_iterator pos) {
-  auto result = pos;
-  std::queue<edge_iterator> to_visit;
-  to_visit.push(pos);
-  while (!to_visit.empty()) {
-    pos = to_visit.front();
-    to_visit.pop();
-    assert(pos != edges_.end());
-    auto child = pos->first;
-    result = edges_.erase(pos);
-    if (0 == edges_.count(
-                 child)) {  // reference count of child vertex is zero, so erase
-      auto vertex = vertices_.find(child);
-      if (vertices_.end() != vertex) {
-        for (const auto& grandchild : vertex->second.edges_) {
-          auto it = find(edge_type(grandchild, vertex->first));
-          to_visit.push(it);
-        }
-        vertices_.erase(vertex);
+typename managed_container<V, E>::size_type managed_container<V, E>::count(
+    const typename managed_container::key_type& key) const {
+  if constexpr (is_intrusive) {
+    auto it = vertices_.find(key);
+    return it == vertices_.end() ? 0 : it->second.references();
+  } else {
+    return edges_.count(key);
+  }
+}
+
+template <typename V, typename E>
+const typename managed_container<V, E>::edge_map_type&
+managed_container<V, E>::parents() const {
+  static_assert(!is_intrusive, "an intrusive managed_container has no index");
+  return edges_;
+}
+
+template <typename V, typename E>
+void managed_container<V, E>::clear() {
+  if constexpr (!is_intrusive) {
+    edges_.clear();
+  }
+  dead_.clear();
+  vertices_.clear();
+}
+
+template <typename V, typename E>
+reclamation_mode managed_container<V, E>::reclamation() const {
+  return reclamation_;
+}
+
+template <typename V, typename E>
+managed_container<V, E>& managed_container<V, E>::reclamation(
+    reclamation_mode value) {
+  reclamation_ = value;
+  return *this;
+}
+
+template <typename V, typename E>
+typename managed_container<V, E>::size_type managed_container<V, E>::garbage()
+    const {
+  return dead_.size();
+}
+
+template <typename V, typename E>
+typename managed_container<V, E>::size_type managed_container<V, E>::collect(
+    size_type budget) {
+  size_type reclaimed = 0;
+  while (reclaimed < budget && !dead_.empty()) {
+    auto key = *dead_.begin();
+    dead_.erase(dead_.begin());
+    auto vertex = vertices_.find(key);
+    if (vertex == vertices_.end() || count(key) != 0) {
+      continue;  // already gone, or referenced again since it was erased
+    }
+    for (const auto& child : vertex->second) {
+      if (0 == remove_edge(child, key)) {
+        dead_.insert(child);
       }
     }
+    discard(vertex);
+    ++reclaimed;
   }
-  return result;
+  return reclaimed;
 }
 
 template <typename V, typename E>
-typename managed_container<V, E>::edge_iterator managed_container<V, E>::find(
-    const typename managed_container<V, E>::edge_type& edge) {
-  auto result = edges_.cend();
-  auto range = edges_.equal_range(edge.first);
-  auto it = std::find(range.first, range.second, edge);
-  if (it != range.second) {
-    result = it;
+template <typename InputIt>
+typename managed_container<V, E>::size_type
+managed_container<V, E>::mark_and_sweep(InputIt first_root, InputIt last_root,
+                                        std::size_t threads) {
+  // index the vertices by key, so that marks fit in a dense bitmap
+  auto vertices = std::vector<iterator>();
+  vertices.reserve(vertices_.size());
+  for (auto it = vertices_.begin(); it != vertices_.end(); ++it) {
+    vertices.push_back(it);
   }
-  return result;
+  auto by_key = [](const iterator& lhs, const iterator& rhs) {
+    return lhs->first < rhs->first;
+  };
+  if (!std::is_sorted(vertices.begin(), vertices.end(), by_key)) {
+    std::sort(vertices.begin(), vertices.end(), by_key);
+  }
+  auto npos = vertices.size();
+  auto index = [&vertices, npos](const key_type& key) {
+    auto it = std::lower_bound(vertices.begin(), vertices.end(), key,
+                               [](const iterator& entry, const key_type& k) {
+                                 return entry->first < k;
+                               });
+    return it != vertices.end() && !(key < (*it)->first)
+               ? static_cast<std::size_t>(it - vertices.begin())
+               : npos;
+  };
+
+  auto marked = atomic_bitmap(vertices.size());
+  auto is_root = std::vector<bool>(vertices.size(), false);
+  auto frontier = std::vector<std::size_t>();
+  for (; first_root != last_root; ++first_root) {
+    auto root = index(*first_root);
+    if (root != npos && marked.set(root)) {
+      is_root[root] = true;
+      frontier.push_back(root);
+    }
+  }
+  threads = std::max<std::size_t>(threads, 1);
+  auto found = std::vector<std::vector<std::size_t>>(threads);
+  while (!frontier.empty()) {
+    parallel_for(
+        frontier.size(), threads,
+        [&](std::size_t first, std::size_t last, std::size_t chunk) {
+          auto& next = found[chunk];
+          for (; first != last; ++first) {
+            for (const auto& link : vertices[frontier[first]]->second) {
+              auto child = index(link);
+              if (child != npos && marked.set(child)) {
+                next.push_back(child);
+              }
+            }
+          }
+        },
+        64);
+    frontier.clear();
+    for (auto& next : found) {
+      frontier.insert(frontier.end(), next.begin(), next.end());
+      next.clear();
+    }
+  }
+
+  // rebuild the bookkeeping from the edges between marked vertices only
+  auto references = std::vector<size_type>(vertices.size(), 0);
+  auto edges = std::vector<std::pair<key_type, key_type>>();  // child, parent
+  for (std::size_t i = 0; i < vertices.size(); ++i) {
+    if (!marked.test(i)) {
+      continue;
+    }
+    for (const auto& link : vertices[i]->second) {
+      auto child = index(link);
+      if (child == npos) {
+        continue;
+      }
+      ++references[child];
+      if constexpr (!is_intrusive) {
+        edges.emplace_back(link, vertices[i]->first);
+      }
+    }
+  }
+  if constexpr (is_intrusive) {
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+      if (marked.test(i)) {
+        vertices[i]->second.reset(references[i]);
+      }
+    }
+  } else {
+    std::sort(edges.begin(), edges.end());
+    edges_.clear();
+    auto edge_hint = edges_.end();
+    for (auto& [child, parent] : edges) {
+      edge_hint = std::next(
+          edges_.emplace_hint(edge_hint, std::move(child), std::move(parent)));
+    }
+  }
+
+  // a survivor left unreferenced is pending collection, unless it is a root
+  // which was not erased
+  auto pending = std::set<key_type>();
+  pending.swap(dead_);
+  for (std::size_t i = 0; i < vertices.size(); ++i) {
+    const auto& key = vertices[i]->first;
+    if (marked.test(i) && references[i] == 0 &&
+        (!is_root[i] || pending.count(key) != 0)) {
+      dead_.insert(key);
+    }
+  }
+
+  size_type swept = 0;
+  for (std::size_t i = 0; i < vertices.size(); ++i) {
+    if (!marked.test(i)) {
+      discard(vertices[i]);
+      ++swept;
+    }
+  }
+  return swept;
 }
 
 template <typename V, typename E>
-typename managed_container<V, E>::edge_iterator managed_container<V, E>::erase(
-    const typename managed_container<V, E>::edge_type& edge) {
-  auto result = find(edge);
-  if (result != edges_.end()) {
-    result = erase(result);
+void managed_container<V, E>::acquire(const key_type& child,
+                                      const key_type& parent) {
+  if constexpr (is_intrusive) {
+    auto it = vertices_.find(child);
+    assert(it != vertices_.end());
+    if (it != vertices_.end()) {
+      it->second.acquire();
+    }
+  } else {
+    edges_.insert(std::make_pair(child, parent));
   }
-  return result;
 }
 
 template <typename V, typename E>
-typename managed_container<V, E>::size_type managed_container<V, E>::count(
-    const typename managed_container::key_type& key) {
-  return edges_.count(key);
+typename managed_container<V, E>::size_type
+managed_container<V, E>::remove_edge(const key_type& child,
+                                     const key_type& parent) {
+  if constexpr (is_intrusive) {
+    (void)parent;
+    auto it = vertices_.find(child);
+    return it == vertices_.end() ? 0 : it->second.release();
+  } else {
+    auto range = edges_.equal_range(child);
+    auto it = std::find_if(range.first, range.second, [&parent](auto& e) {
+      return e.second == parent;
+    });
+    if (it != range.second) {
+      edges_.erase(it);
+    }
+    return edges_.count(child);
+  }
 }
 
 template <typename V, typename E>
-void managed_container<V, E>::clear() {
-  edges_.clear();
-  vertices_.clear();
+void managed_container<V, E>::release(const key_type& child,
+                                      const key_type& parent) {
+  std::queue<std::pair<key_type, key_type>> to_visit;
+  to_visit.emplace(child, parent);
+  while (!to_visit.empty()) {
+    auto [key, source] = std::move(to_visit.front());
+    to_visit.pop();
+    if (0 == remove_edge(key, source)) {
+      if (reclamation_ == reclamation_mode::deferred) {
+        dead_.insert(key);
+        continue;
+      }
+      auto vertex = vertices_.find(key);
+      if (vertices_.end() != vertex) {  // unreferenced, so erase
+        for (const auto& grandchild : vertex->second) {
+          to_visit.emplace(grandchild, key);
+        }
+        discard(vertex);
+      }
+    }
+  }
+}
+
+template <typename V, typename E>
+void managed_container<V, E>::discard(iterator pos) {
+  if constexpr (has_quick_erase<V>::value) {
+    vertices_.quick_erase(pos);
+  } else {
+    vertices_.erase(pos);
+  }
 }
 
 }  // namespace vertex
@@ -1,19 +1,32 @@
 #pragma once
 
 #include <algorithm>
+#include <iterator>
+#include <type_traits>
 #include <vector>
 
 namespace vertex {
 
+/** Ordering policy which keeps links in insertion order */
+struct unordered_links {};
+
+/** Ordering policy which keeps links sorted, so that look-ups are binary
+ * searches and bulk insertion is a merge */
+struct ordered_links {};
+
 /** A node in a tree, which has data of type T, and a collection of Link
  * pointers to child nodes.
  * Provides a set-like interface for adding and removing children
  *
  * Impl is required to implement get_links() and get_element(), from which
  * we offer comparison operators, swap, and a std::set-like interface
+ *
+ * Ordering is either unordered_links or ordered_links. An Impl using
+ * ordered_links must call order_links() whenever it assigns links wholesale.
  * */
 template <typename Impl, typename Link, typename T,
-          typename Container = std::vector<Link>>
+          typename Container = std::vector<Link>,
+          typename Ordering = unordered_links>
 class node {
  public:
   using container_type = Container;
@@ -25,8 +38,13 @@ class node {
   using size_type = std::size_t;
   using link_type = value_type;
   using pointer = T*;
+  using ordering_type = Ordering;
+
+  static constexpr bool is_ordered = std::is_same_v<Ordering, ordered_links>;
 
   static_assert(std::is_same<key_type, value_type>::value);
+  static_assert(is_ordered || std::is_same_v<Ordering, unordered_links>,
+                "Ordering must be unordered_links or ordered_links");
 
   /** Exchanges the contents of the Node with those of other */
   void swap(node& other);
@@ -82,147 +100,209 @@ class node {
   /** Compare the contents and children of a Node against another */
   bool operator!=(const node& rhs) const;
 
+ protected:
+  /** Restores the ordering invariant after links were assigned wholesale */
+  void order_links();
+
  private:
   const container_type& links() const;
   container_type& links();
 };
 
-template <typename Impl, typename Link, typename T, typename Container>
-void node<Impl, Link, T, Container>::swap(node& other) {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+void node<Impl, Link, T, Container, Ordering>::swap(node& other) {
   std::swap(this->link(), other.link());
   std::swap(this->value(), other.value());
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-typename node<Impl, Link, T, Container>::pointer
-node<Impl, Link, T, Container>::get() const {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+typename node<Impl, Link, T, Container, Ordering>::pointer
+node<Impl, Link, T, Container, Ordering>::get() const {
   return static_cast<const Impl*>(this)->get_element();
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
 typename std::add_lvalue_reference<T>::type
-    node<Impl, Link, T, Container>::operator*() {
+    node<Impl, Link, T, Container, Ordering>::operator*() {
   auto pimpl = static_cast<Impl*>(this);
   return pimpl->get_element();
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
 typename std::add_lvalue_reference<T>::type
-    node<Impl, Link, T, Container>::operator*() const {
+    node<Impl, Link, T, Container, Ordering>::operator*() const {
   auto pimpl = static_cast<const Impl*>(this);
   return const_cast<Impl*>(pimpl)->get_element();
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-typename node<Impl, Link, T, Container>::pointer
-    node<Impl, Link, T, Container>::operator->() const {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+typename node<Impl, Link, T, Container, Ordering>::pointer
+    node<Impl, Link, T, Container, Ordering>::operator->() const {
   return static_cast<const Impl*>(this)->get_element();
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-typename node<Impl, Link, T, Container>::const_iterator
-node<Impl, Link, T, Container>::begin() const {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+typename node<Impl, Link, T, Container, Ordering>::const_iterator
+node<Impl, Link, T, Container, Ordering>::begin() const {
   return links().begin();
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-typename node<Impl, Link, T, Container>::const_iterator
-node<Impl, Link, T, Container>::end() const {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+typename node<Impl, Link, T, Container, Ordering>::const_iterator
+node<Impl, Link, T, Container, Ordering>::end() const {
   return links().end();
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-const typename node<Impl, Link, T, Container>::container_type&
-node<Impl, Link, T, Container>::links() const {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+const typename node<Impl, Link, T, Container, Ordering>::container_type&
+node<Impl, Link, T, Container, Ordering>::links() const {
   auto pimpl = static_cast<const Impl*>(this);
   const auto& result = const_cast<Impl*>(pimpl)->get_links();
   return result;
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-typename node<Impl, Link, T, Container>::container_type&
-node<Impl, Link, T, Container>::links() {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+typename node<Impl, Link, T, Container, Ordering>::container_type&
+node<Impl, Link, T, Container, Ordering>::links() {
   return static_cast<Impl*>(this)->get_links();
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
 template <typename InputIt>
-void node<Impl, Link, T, Container>::insert(InputIt first, InputIt last) {
-  for (auto it = first; it != last; ++it) {
-    insert(*it);
+void node<Impl, Link, T, Container, Ordering>::insert(InputIt first,
+                                                       InputIt last) {
+  if constexpr (is_ordered) {  // append, then merge the sorted runs
+    auto& container = links();
+    auto offset = container.size();
+    container.insert(container.end(), first, last);
+    auto middle = std::next(container.begin(), offset);
+    std::sort(middle, container.end());
+    std::inplace_merge(container.begin(), middle, container.end());
+    container.erase(std::unique(container.begin(), container.end()),
+                    container.end());
+  } else {
+    for (auto it = first; it != last; ++it) {
+      insert(*it);
+    }
   }
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
 template <typename K>
-typename node<Impl, Link, T, Container>::size_type
-node<Impl, Link, T, Container>::count(const K& x) {
-  return std::count(begin(), end(), x);
+typename node<Impl, Link, T, Container, Ordering>::size_type
+node<Impl, Link, T, Container, Ordering>::count(const K& x) {
+  if constexpr (is_ordered) {
+    auto range = std::equal_range(begin(), end(), x);
+    return static_cast<size_type>(std::distance(range.first, range.second));
+  } else {
+    return std::count(begin(), end(), x);
+  }
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-bool node<Impl, Link, T, Container>::operator==(
-    const node<Impl, Link, T, Container>& rhs) const {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+bool node<Impl, Link, T, Container, Ordering>::operator==(
+    const node<Impl, Link, T, Container, Ordering>& rhs) const {
   return **this == *rhs && this->links() == rhs.links();
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-bool node<Impl, Link, T, Container>::operator!=(
-    const node<Impl, Link, T, Container>& rhs) const {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+bool node<Impl, Link, T, Container, Ordering>::operator!=(
+    const node<Impl, Link, T, Container, Ordering>& rhs) const {
   return !(*this == rhs);
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-std::pair<typename node<Impl, Link, T, Container>::iterator, bool>
-node<Impl, Link, T, Container>::insert(const value_type& link) {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+std::pair<typename node<Impl, Link, T, Container, Ordering>::iterator, bool>
+node<Impl, Link, T, Container, Ordering>::insert(const value_type& link) {
   auto first = links().begin();
   auto last = links().end();
-  auto result = std::pair(std::find(first, last, link), true);
-  result.second = result.first == last;
+  auto result = std::pair(last, true);
+  if constexpr (is_ordered) {
+    result.first = std::lower_bound(first, last, link);
+    result.second = result.first == last || !(*result.first == link);
+  } else {
+    result.first = std::find(first, last, link);
+    result.second = result.first == last;
+  }
   if (result.second) {
     result.first = links().insert(result.first, link);
   }
   return result;
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-typename node<Impl, Link, T, Container>::size_type
-node<Impl, Link, T, Container>::size() const {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+typename node<Impl, Link, T, Container, Ordering>::size_type
+node<Impl, Link, T, Container, Ordering>::size() const {
   return links().size();
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-bool node<Impl, Link, T, Container>::empty() const {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+bool node<Impl, Link, T, Container, Ordering>::empty() const {
   return links().empty();
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-void node<Impl, Link, T, Container>::clear() noexcept {
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+void node<Impl, Link, T, Container, Ordering>::clear() noexcept {
   links().clear();
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
-typename node<Impl, Link, T, Container>::size_type
-node<Impl, Link, T, Container>::erase(
-    const typename node<Impl, Link, T, Container>::key_type& key) {
-  auto it = begin();
-  size_type result = 0;
-  while (it != end()) {
-    it = find(key);
-    if (it != end()) {
-      links().erase(it);
-      ++result;
-    }
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+typename node<Impl, Link, T, Container, Ordering>::size_type
+node<Impl, Link, T, Container, Ordering>::erase(
+    const typename node<Impl, Link, T, Container, Ordering>::key_type& key) {
+  auto& container = links();
+  auto range = std::make_pair(container.begin(), container.end());
+  if constexpr (is_ordered) {
+    range = std::equal_range(container.begin(), container.end(), key);
+  } else {
+    range.first = std::remove(container.begin(), container.end(), key);
   }
+  auto result =
+      static_cast<size_type>(std::distance(range.first, range.second));
+  container.erase(range.first, range.second);
   return result;
 }
 
-template <typename Impl, typename Link, typename T, typename Container>
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
+void node<Impl, Link, T, Container, Ordering>::order_links() {
+  if constexpr (is_ordered) {
+    auto& container = links();
+    std::sort(container.begin(), container.end());
+    container.erase(std::unique(container.begin(), container.end()),
+                    container.end());
+  }
+}
 
+template <typename Impl, typename Link, typename T, typename Container,
+          typename Ordering>
 template <typename K>
-typename node<Impl, Link, T, Container>::const_iterator
-node<Impl, Link, T, Container>::find(const K& x) const {
-  return std::find(begin(), end(), x);
+typename node<Impl, Link, T, Container, Ordering>::const_iterator
+node<Impl, Link, T, Container, Ordering>::find(const K& x) const {
+  if constexpr (is_ordered) {
+    auto it = std::lower_bound(begin(), end(), x);
+    return it != end() && *it == x ? it : end();
+  } else {
+    return std::find(begin(), end(), x);
+  }
 }
 
 }  // namespace vertex
@@ -0,0 +1 @@
+#include <vertex/parallel_breadth_first.h>
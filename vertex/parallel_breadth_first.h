@@ -0,0 +1,187 @@
+#pragma once
+
+#include <vertex/atomic_bitmap.h>
+#include <vertex/csr_graph.h>
+#include <vertex/edge.h>
+#include <vertex/parallel_for.h>
+#include <vertex/predicate.h>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace vertex {
+
+/** Tuning for parallel_breadth_first */
+struct parallel_bfs_options {
+  /** Number of threads which expand each level */
+  std::size_t threads = default_concurrency();
+
+  /** Allow bottom-up steps, in which every unvisited vertex searches its
+   * parents for one in the frontier, instead of the frontier searching its
+   * children. This pays off for the large middle levels of wide graphs, and
+   * costs one transposed copy of the edges */
+  bool direction_optimizing = true;
+
+  /** Step bottom-up once the edges leaving the frontier exceed 1 / alpha of
+   * the edges leaving unvisited vertices */
+  std::size_t alpha = 14;
+
+  /** Step top-down again once the frontier holds fewer than 1 / beta of the
+   * vertices */
+  std::size_t beta = 24;
+
+  /** Minimum number of vertices given to each thread */
+  std::size_t grain = 256;
+};
+
+/** Level-synchronous breadth first search of a csr_graph from root.
+ *
+ * Each level is expanded across options.threads threads, which claim
+ * vertices in a shared atomic bitmap and collect the next level in buffers
+ * of their own. Once a level is complete, visit(depth, level) is called on
+ * the calling thread with the indices of the vertices first reached at that
+ * depth, starting with {root} at depth 0. Vertices within a level are in no
+ * particular order.
+ *
+ * predicate is tested, concurrently, on every edge considered, as in
+ * csr_traversal. An empty predicate_function traverses every edge.
+ * @return the number of vertices reached, including root */
+template <typename Container, typename Visitor,
+          typename Predicate = unconditional<Container>>
+std::size_t parallel_breadth_first(
+    const csr_graph<Container>& graph, std::size_t root, Visitor visit,
+    const parallel_bfs_options& options = parallel_bfs_options(),
+    Predicate predicate = Predicate());
+
+template <typename Container, typename Visitor, typename Predicate>
+std::size_t parallel_breadth_first(const csr_graph<Container>& graph,
+                                   std::size_t root, Visitor visit,
+                                   const parallel_bfs_options& options,
+                                   Predicate predicate) {
+  using size_type = std::size_t;
+  constexpr auto npos = csr_graph<Container>::npos;
+  if (root == npos || root >= graph.size()) {
+    return 0;
+  }
+  auto is_traversable = [&graph, &predicate](size_type source,
+                                             size_type target) {
+    if constexpr (is_unconditional_v<Container, Predicate>) {
+      return true;
+    } else if constexpr (std::is_same_v<Predicate,
+                                        predicate_function<Container>>) {
+      return !predicate ||
+             predicate(edge<Container>(graph.key(source), graph.key(target)));
+    } else {
+      return static_cast<bool>(predicate(
+          edge<Container>(graph.key(source), graph.key(target))));
+    }
+  };
+
+  // parents of each vertex, for bottom-up steps
+  auto parent_offsets = std::vector<size_type>();
+  auto parents = std::vector<size_type>();
+  if (options.direction_optimizing) {
+    parent_offsets.assign(graph.size() + 1, 0);
+    for (size_type source = 0; source < graph.size(); ++source) {
+      for (auto target : graph.children(source)) {
+        if (target != npos) {
+          ++parent_offsets[target + 1];
+        }
+      }
+    }
+    for (size_type i = 0; i < graph.size(); ++i) {
+      parent_offsets[i + 1] += parent_offsets[i];
+    }
+    parents.resize(parent_offsets.back());
+    auto cursor = parent_offsets;
+    for (size_type source = 0; source < graph.size(); ++source) {
+      for (auto target : graph.children(source)) {
+        if (target != npos) {
+          parents[cursor[target]++] = source;
+        }
+      }
+    }
+  }
+
+  auto threads = std::max<size_type>(options.threads, 1);
+  auto visited = atomic_bitmap(graph.size());
+  auto found = std::vector<std::vector<size_type>>(threads);
+  auto frontier = std::vector<size_type>{root};
+  visited.set(root);
+  auto reached = size_type(1);
+  auto unexplored_edges = graph.edge_count() - graph.children(root).size();
+  auto bottom_up = false;
+  auto in_frontier = std::vector<bool>();
+
+  for (size_type depth = 0; !frontier.empty(); ++depth) {
+    visit(depth, static_cast<const std::vector<size_type>&>(frontier));
+
+    if (options.direction_optimizing) {
+      size_type frontier_edges = 0;
+      for (auto vertex : frontier) {
+        frontier_edges += graph.children(vertex).size();
+      }
+      if (!bottom_up) {
+        bottom_up = frontier_edges * options.alpha > unexplored_edges;
+      } else {
+        bottom_up = frontier.size() * options.beta >= graph.size();
+      }
+    }
+
+    if (bottom_up) {
+      in_frontier.assign(graph.size(), false);
+      for (auto vertex : frontier) {
+        in_frontier[vertex] = true;
+      }
+      parallel_for(
+          graph.size(), threads,
+          [&](size_type first, size_type last, size_type chunk) {
+            auto& next = found[chunk];
+            for (auto target = first; target != last; ++target) {
+              if (visited.test(target)) {
+                continue;
+              }
+              for (auto i = parent_offsets[target];
+                   i != parent_offsets[target + 1]; ++i) {
+                auto source = parents[i];
+                if (in_frontier[source] && is_traversable(source, target)) {
+                  visited.set(target);  // only this thread examines target
+                  next.push_back(target);
+                  break;
+                }
+              }
+            }
+          },
+          options.grain);
+    } else {
+      parallel_for(
+          frontier.size(), threads,
+          [&](size_type first, size_type last, size_type chunk) {
+            auto& next = found[chunk];
+            for (; first != last; ++first) {
+              auto source = frontier[first];
+              for (auto target : graph.children(source)) {
+                if (target != npos && !visited.test(target) &&
+                    is_traversable(source, target) && visited.set(target)) {
+                  next.push_back(target);
+                }
+              }
+            }
+          },
+          options.grain);
+    }
+
+    frontier.clear();
+    for (auto& next : found) {
+      frontier.insert(frontier.end(), next.begin(), next.end());
+      next.clear();
+    }
+    reached += frontier.size();
+    for (auto vertex : frontier) {
+      unexplored_edges -= graph.children(vertex).size();
+    }
+  }
+  return reached;
+}
+
+}  // namespace vertex
@@ -0,0 +1,9 @@
+#include <vertex/parallel_for.h>
+
+namespace vertex {
+
+std::size_t default_concurrency() {
+  return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+}  // namespace vertex
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace vertex {
+
+/** Returns the number of threads to use when none is specified */
+std::size_t default_concurrency();
+
+/** Splits [0, size) into contiguous chunks of at least grain elements, one
+ * per thread, and calls fn(first, last, chunk) for each of them concurrently.
+ *
+ * The calling thread processes the last chunk; at most threads - 1 further
+ * threads are started. Returns once every chunk is done, rethrowing the first
+ * exception thrown by fn, if any. */
+template <typename Function>
+void parallel_for(std::size_t size, std::size_t threads, Function fn,
+                  std::size_t grain = 1024);
+
+template <typename Function>
+void parallel_for(std::size_t size, std::size_t threads, Function fn,
+                  std::size_t grain) {
+  grain = std::max<std::size_t>(grain, 1);
+  auto chunks = std::clamp<std::size_t>((size + grain - 1) / grain, 1,
+                                        std::max<std::size_t>(threads, 1));
+  if (chunks == 1) {
+    fn(std::size_t(0), size, std::size_t(0));
+    return;
+  }
+  auto errors = std::vector<std::exception_ptr>(chunks);
+  auto run = [&](std::size_t chunk) {
+    try {
+      fn(size * chunk / chunks, size * (chunk + 1) / chunks, chunk);
+    } catch (...) {
+      errors[chunk] = std::current_exception();
+    }
+  };
+  auto workers = std::vector<std::thread>();
+  workers.reserve(chunks - 1);
+  for (std::size_t chunk = 0; chunk + 1 < chunks; ++chunk) {
+    workers.emplace_back(run, chunk);
+  }
+  run(chunks - 1);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+}  // namespace vertex
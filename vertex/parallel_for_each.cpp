@@ -0,0 +1 @@
+#include <vertex/parallel_for_each.h>
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <vertex/edge.h>
+#include <vertex/parallel_for.h>
+#include <vertex/predicate.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vertex {
+
+/** Tuning for parallel_for_each */
+struct parallel_for_each_options {
+  /** Number of threads which visit vertices, including the calling thread */
+  std::size_t threads = default_concurrency();
+
+  /** Subtrees rooted at this depth or deeper are visited sequentially by the
+   * task which reaches them, rather than spawned as tasks of their own */
+  std::size_t cutoff = 8;
+};
+
+/** A deque of tasks which its owner pushes and pops at the back, while other
+ * threads steal from the front */
+template <typename T>
+class work_stealing_queue {
+ public:
+  void push(T value);
+
+  /** Pops the most recently pushed task, returning false if there is none */
+  bool pop(T& value);
+
+  /** Takes the least recently pushed task, returning false if there is none */
+  bool steal(T& value);
+
+ private:
+  std::mutex mutex_;
+  std::deque<T> tasks_;
+};
+
+/** Calls fn on every vertex of the subtree at root, concurrently.
+ *
+ * The children of a vertex are spawned as tasks onto per-thread queues, from
+ * which idle threads steal. Threads which find nothing to steal sleep until
+ * a task is queued, or every task has finished. Below options.cutoff, a task
+ * walks the rest of its subtree itself. Edges are tested with predicate as
+ * in the sequential traversals, and a vertex reached through several edges
+ * is visited once per edge. Vertices are visited in no particular order.
+ *
+ * fn and predicate are called concurrently, and predicate through a const
+ * reference. The first exception thrown by either stops the visit and is
+ * rethrown once every thread has finished. */
+template <typename Container, typename Function,
+          typename Predicate = unconditional<Container>>
+void parallel_for_each(
+    const Container& vertices, typename Container::const_iterator root,
+    Function fn, Predicate predicate = Predicate(),
+    const parallel_for_each_options& options = parallel_for_each_options());
+
+template <typename T>
+void work_stealing_queue<T>::push(T value) {
+  auto lock = std::lock_guard<std::mutex>(mutex_);
+  tasks_.push_back(std::move(value));
+}
+
+template <typename T>
+bool work_stealing_queue<T>::pop(T& value) {
+  auto lock = std::lock_guard<std::mutex>(mutex_);
+  if (tasks_.empty()) {
+    return false;
+  }
+  value = std::move(tasks_.back());
+  tasks_.pop_back();
+  return true;
+}
+
+template <typename T>
+bool work_stealing_queue<T>::steal(T& value) {
+  auto lock = std::lock_guard<std::mutex>(mutex_);
+  if (tasks_.empty()) {
+    return false;
+  }
+  value = std::move(tasks_.front());
+  tasks_.pop_front();
+  return true;
+}
+
+template <typename Container, typename Function, typename Predicate>
+void parallel_for_each(const Container& vertices,
+                       typename Container::const_iterator root, Function fn,
+                       Predicate predicate,
+                       const parallel_for_each_options& options) {
+  using edge_type = edge<Container>;
+  static_assert(
+      std::is_invocable_r_v<bool, const Predicate&, const edge_type&>,
+      "Predicate must be callable concurrently through a const reference");
+  if (root == vertices.end()) {
+    return;
+  }
+  const auto& test = predicate;
+  auto is_traversable = [&test](const auto& source, const auto& target) {
+    if constexpr (is_unconditional_v<Container, Predicate>) {
+      return true;
+    } else if constexpr (std::is_same_v<Predicate,
+                                        predicate_function<Container>>) {
+      return !test || test(edge_type(source, target));
+    } else {
+      return static_cast<bool>(test(edge_type(source, target)));
+    }
+  };
+
+  struct task {
+    typename Container::const_iterator vertex;
+    std::size_t depth = 0;
+  };
+  auto threads = std::max<std::size_t>(options.threads, 1);
+  auto queues = std::vector<work_stealing_queue<task>>(threads);
+  auto pending = std::atomic<std::size_t>(1);  // tasks queued or running
+  auto queued = std::atomic<std::size_t>(1);   // tasks waiting in a queue
+  auto sleepers = std::atomic<std::size_t>(0);
+  auto idle_mutex = std::mutex();
+  auto idle = std::condition_variable();
+  auto failed = std::atomic<bool>(false);
+  auto error = std::exception_ptr();
+  auto error_mutex = std::mutex();
+  queues[0].push(task{root, 0});
+
+  // a sleeper counts itself before testing whether to wait, and a waker
+  // changes the counters before testing for sleepers, so one of them sees
+  // the other. Taking the mutex keeps the notification from falling between
+  // a sleeper's test and its wait
+  auto wake = [&](bool all) {
+    if (sleepers.load() == 0) {
+      return;
+    }
+    auto lock = std::lock_guard<std::mutex>(idle_mutex);
+    if (all) {
+      idle.notify_all();
+    } else {
+      idle.notify_one();
+    }
+  };
+
+  auto run = [&](std::size_t worker, task first) {
+    auto to_visit = std::vector<task>{std::move(first)};
+    while (!to_visit.empty() && !failed.load(std::memory_order_relaxed)) {
+      auto current = std::move(to_visit.back());
+      to_visit.pop_back();
+      fn(*current.vertex);
+      for (const auto& link : current.vertex->second) {
+        auto child = vertices.find(link);
+        if (child == vertices.end() ||
+            !is_traversable(current.vertex->first, link)) {
+          continue;
+        }
+        auto next = task{child, current.depth + 1};
+        if (next.depth < options.cutoff) {
+          pending.fetch_add(1);
+          queued.fetch_add(1);
+          queues[worker].push(std::move(next));
+          wake(false);
+        } else {
+          to_visit.push_back(std::move(next));
+        }
+      }
+    }
+  };
+  auto work = [&](std::size_t worker) {
+    auto current = task();
+    while (pending.load() != 0 && !failed.load()) {
+      auto found = queues[worker].pop(current);
+      for (std::size_t i = 1; !found && i < threads; ++i) {
+        found = queues[(worker + i) % threads].steal(current);
+      }
+      if (!found) {
+        auto lock = std::unique_lock<std::mutex>(idle_mutex);
+        sleepers.fetch_add(1);
+        // the timeout is only a backstop, as every push and the last task to
+        // finish wake sleepers
+        idle.wait_for(lock, std::chrono::milliseconds(10), [&] {
+          return queued.load() != 0 || pending.load() == 0 || failed.load();
+        });
+        sleepers.fetch_sub(1);
+        continue;
+      }
+      queued.fetch_sub(1);
+      try {
+        run(worker, std::move(current));
+      } catch (...) {
+        auto lock = std::lock_guard<std::mutex>(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        failed = true;
+        wake(true);
+      }
+      if (pending.fetch_sub(1) == 1) {
+        wake(true);
+      }
+    }
+  };
+
+  auto workers = std::vector<std::thread>();
+  workers.reserve(threads - 1);
+  for (std::size_t worker = 1; worker < threads; ++worker) {
+    workers.emplace_back(work, worker);
+  }
+  work(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace vertex
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <boost/iterator/indirect_iterator.hpp>
+#include <cstddef>
 #include <vector>
 
 namespace vertex {
@@ -7,4 +10,105 @@ namespace vertex {
 template <typename Container>
 using path = std::vector<typename Container::key_type>;
 
+/** A read-only view of a path whose segments are stored elsewhere, e.g. as
+ * the keys of the vertices along it, so that it is formed without copying
+ * them. The view is invalidated when the path it was taken from changes */
+template <typename Container>
+class path_view {
+ public:
+  using value_type = typename Container::key_type;
+  using size_type = std::size_t;
+  using const_reference = const value_type&;
+  using const_iterator = boost::indirect_iterator<const value_type* const*>;
+  using iterator = const_iterator;
+
+  path_view() = default;
+
+  /** Views the size segments pointed to from segments */
+  path_view(const value_type* const* segments, size_type size);
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  [[nodiscard]] bool empty() const;
+  size_type size() const;
+
+  const_reference operator[](size_type i) const;
+  const_reference front() const;
+  const_reference back() const;
+
+  /** Copies the segments into a path */
+  path<Container> to_path() const;
+
+  friend bool operator==(const path_view& lhs, const path<Container>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+  friend bool operator==(const path<Container>& lhs, const path_view& rhs) {
+    return rhs == lhs;
+  }
+
+  friend bool operator!=(const path_view& lhs, const path<Container>& rhs) {
+    return !(lhs == rhs);
+  }
+
+  friend bool operator!=(const path<Container>& lhs, const path_view& rhs) {
+    return !(rhs == lhs);
+  }
+
+ private:
+  const value_type* const* segments_ = nullptr;
+  size_type size_ = 0;
+};
+
+template <typename Container>
+path_view<Container>::path_view(const value_type* const* segments,
+                                size_type size)
+    : segments_(segments), size_(size) {}
+
+template <typename Container>
+typename path_view<Container>::const_iterator path_view<Container>::begin()
+    const {
+  return const_iterator(segments_);
+}
+
+template <typename Container>
+typename path_view<Container>::const_iterator path_view<Container>::end()
+    const {
+  return const_iterator(segments_ + size_);
+}
+
+template <typename Container>
+bool path_view<Container>::empty() const {
+  return size_ == 0;
+}
+
+template <typename Container>
+typename path_view<Container>::size_type path_view<Container>::size() const {
+  return size_;
+}
+
+template <typename Container>
+typename path_view<Container>::const_reference
+path_view<Container>::operator[](size_type i) const {
+  return *segments_[i];
+}
+
+template <typename Container>
+typename path_view<Container>::const_reference path_view<Container>::front()
+    const {
+  return *segments_[0];
+}
+
+template <typename Container>
+typename path_view<Container>::const_reference path_view<Container>::back()
+    const {
+  return *segments_[size_ - 1];
+}
+
+template <typename Container>
+path<Container> path_view<Container>::to_path() const {
+  return path<Container>(begin(), end());
+}
+
 }  // namespace vertex
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <vertex/glob_traversal.h>
 #include <vertex/iterator_recorder.h>
 #include <vertex/path.h>
 #include <vertex/pre_order_traversal.h>
 #include <algorithm>
+#include <boost/iterator/indirect_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 #include <boost/iterator/transform_iterator.hpp>
+#include <boost/range/iterator_range.hpp>
 #include <functional>
+#include <iterator>
+#include <string_view>
 #include <vector>
 
 namespace vertex {
@@ -23,7 +29,7 @@ class path_map {
   class decoder {
    public:
     decoder() = default;
-    explicit decoder(const Container& nodes);
+    explicit decoder(const Container& nodes, key_type path = key_type());
     value_type operator()(const typename Container::value_type& value) const;
 
    private:
@@ -38,7 +44,8 @@ class path_map {
   using pointer = typename Container::pointer;
   using const_pointer = typename Container::const_pointer;
 
-  using traversal_type = pre_order_traversal<Container>;
+  using traversal_type =
+      pre_order_traversal<Container, unconditional<Container>>;
 
   using transform_type = boost::transform_iterator<decoder, traversal_type,
                                                    value_type, value_type>;
@@ -46,6 +53,69 @@ class path_map {
   using iterator = toolbox::iterator_recorder<transform_type>;
   using const_iterator = iterator;
 
+  /** A path and the node stored at its end, both viewed in place */
+  struct entry {
+    path_view<Container> path;
+    const mapped_type& node;
+  };
+
+  /** Iterates over the entries of a path_map in pre-order. The segments of
+   * the current path are kept as pointers to the keys of the vertices on the
+   * traversal stack, so advancing neither copies keys or nodes nor
+   * allocates once the stack has reached its greatest depth. An entry is
+   * invalidated when the iterator it came from is advanced */
+  class entry_iterator
+      : public boost::iterator_facade<entry_iterator, entry,
+                                      boost::forward_traversal_tag, entry> {
+   public:
+    entry_iterator() = default;
+
+    /** Starts at the current position of traversal, which is reached along
+     * prefix */
+    entry_iterator(traversal_type traversal,
+                   std::vector<const typename Container::key_type*> prefix);
+
+   private:
+    friend class boost::iterator_core_access;
+
+    entry dereference() const;
+    void increment();
+    bool equal(const entry_iterator& other) const;
+
+    /** Replaces the segments below the prefix with those of the position */
+    void update();
+
+    traversal_type traversal_;
+    std::vector<const typename Container::key_type*> path_;
+    std::size_t prefix_size_ = 0;
+  };
+
+  using entry_range = boost::iterator_range<entry_iterator>;
+
+  using glob_type = glob_traversal<Container>;
+
+  /** Iterates over the entries which match a glob pattern, viewing them in
+   * place as entry_iterator does */
+  class glob_iterator
+      : public boost::iterator_facade<glob_iterator, entry,
+                                      boost::forward_traversal_tag, entry> {
+   public:
+    glob_iterator() = default;
+
+    explicit glob_iterator(glob_type traversal);
+
+   private:
+    friend class boost::iterator_core_access;
+
+    entry dereference() const;
+    void increment();
+    bool equal(const glob_iterator& other) const;
+
+    glob_type traversal_;
+  };
+
+  using glob_range = boost::iterator_range<glob_iterator>;
+
   explicit path_map(Container& nodes);
 
   const typename Container::const_iterator& root() const;
@@ -62,6 +132,28 @@ class path_map {
 
   iterator end() const;
 
+  /** Returns every entry below the root, in the order of begin(), without
+   * copying paths or nodes */
+  entry_range entries() const;
+
+  /** Returns the entries below prefix, e.g. everything under /home/bob, in
+   * the order of entries(). The vertex at prefix is found by following one
+   * link per segment, and only its subtree is then traversed, to at most
+   * max_depth segments below prefix. An empty prefix lists the whole map.
+   * @return an empty range if prefix is not in the map */
+  entry_range subtree(const key_type& prefix,
+                      size_type max_depth = traversal_type::unlimited) const;
+
+  /** Returns the entries directly below prefix, as a directory listing */
+  entry_range children(const key_type& prefix) const;
+
+  /** Returns the entries whose paths match pattern, in pre-order, e.g.
+   * every log file below /home/bob, given 'home', 'bob' and '**.log' as its
+   * segments. Subtrees which cannot match are not traversed, and literal
+   * segments are followed directly, so that a pattern rooted in literals
+   * costs no more than a search for them. See glob_pattern for the syntax */
+  glob_range glob(std::string_view pattern) const;
+
   /** Search for a path with partial matching
    * @return Value containing all matched path segments */
   iterator search(const key_type& p) const;
@@ -78,7 +170,49 @@ class path_map {
 
   std::pair<iterator, bool> insert(const value_type& value);
 
+  /** Loads the (path, node) pairs of [first, last), e.g. a namespace
+   * import, in a single pass without searching the map.
+   *
+   * The paths under construction are held as a stack of pending vertices,
+   * so that a prefix shared by consecutive paths is visited once, and each
+   * vertex is written to the Container once, when the stream moves past it.
+   * Sorted input, in which every path follows its prefixes and siblings are
+   * adjacent, therefore costs one write per distinct vertex. Unsorted input
+   * is loaded correctly, rewriting a vertex each time it is reopened.
+   *
+   * As with insert, a path already in the map, or repeated in the input,
+   * keeps its first node. A missing intermediate segment gets an empty node.
+   * @return the number of paths inserted */
+  template <typename InputIt>
+  size_type load(InputIt first, InputIt last);
+
+  /** Inserts a batch of (path, node) pairs, keeping the node of a path
+   * already in the map or repeated in the batch, as insert does for each.
+   *
+   * The batch is ordered by path and loaded in one pass, so an ancestor
+   * shared by many of its paths, such as the root, is copied and written
+   * once per batch rather than once per path.
+   * @return the number of paths inserted */
+  template <typename ForwardIt>
+  size_type insert(ForwardIt first, ForwardIt last);
+
+  /** Writes a batch of (path, node) pairs as insert(first, last) does, but
+   * replaces the node of a path already in the map, keeping the links to
+   * its children. Of a path repeated in the batch, the last node is kept.
+   * @return the number of paths inserted rather than assigned */
+  template <typename ForwardIt>
+  size_type insert_or_assign(ForwardIt first, ForwardIt last);
+
  private:
+  /** Loads (path, node) pairs along a stack of pending vertices, as load
+   * describes. With assign, the node of an existing path is replaced */
+  template <typename InputIt>
+  size_type merge(InputIt first, InputIt last, bool assign);
+
+  /** Orders a batch by path and merges it */
+  template <typename ForwardIt>
+  size_type merge_batch(ForwardIt first, ForwardIt last, bool assign);
+
   std::pair<typename Container::iterator, bool> insert_or_assign(
       const typename Container::key_type& key,
       typename Container::mapped_type& value);
@@ -92,8 +226,8 @@ path_map<Container>::path_map(Container& nodes)
     : nodes_(&nodes), root_(nodes_->end()) {}
 
 template <typename Container>
-path_map<Container>::decoder::decoder(const Container& nodes)
-    : nodes_(&nodes) {}
+path_map<Container>::decoder::decoder(const Container& nodes, key_type path)
+    : path_(std::move(path)), nodes_(&nodes) {}
 
 template <typename Container>
 typename path_map<Container>::value_type
@@ -159,30 +293,143 @@ typename path_map<Container>::iterator path_map<Container>::cend() const {
   return end();
 }
 
+template <typename Container>
+typename path_map<Container>::entry_range path_map<Container>::entries()
+    const {
+  auto first = traversal_type(nodes(), root_);
+  auto last = first.end();
+  if (first != last) {
+    ++first;  // don't include root in results
+  }
+  return entry_range(entry_iterator(first, {}), entry_iterator(last, {}));
+}
+
+template <typename Container>
+typename path_map<Container>::entry_range path_map<Container>::subtree(
+    const key_type& prefix, size_type max_depth) const {
+  auto segments = std::vector<const typename Container::key_type*>();
+  segments.reserve(prefix.size());
+  auto traversal = traversal_type(nodes(), root_);
+  for (const auto& segment : prefix) {
+    if (!traversal.descend(segment)) {
+      auto last = traversal_type(nodes(), root_).end();
+      return entry_range(entry_iterator(last, {}), entry_iterator(last, {}));
+    }
+    segments.push_back(&traversal->first);
+  }
+  auto first = traversal_type(nodes(), traversal.position(),
+                              unconditional<Container>(), max_depth);
+  auto last = first.end();
+  if (first != last) {
+    ++first;  // the prefix itself is not listed
+  }
+  return entry_range(entry_iterator(first, segments),
+                     entry_iterator(last, {}));
+}
+
+template <typename Container>
+typename path_map<Container>::entry_range path_map<Container>::children(
+    const key_type& prefix) const {
+  return subtree(prefix, 1);
+}
+
+template <typename Container>
+typename path_map<Container>::glob_range path_map<Container>::glob(
+    std::string_view pattern) const {
+  auto first = glob_type(nodes(), root_, glob_pattern(pattern));
+  auto last = first.end();
+  if (first != last) {
+    ++first;  // the root is reached by the empty path, which is not listed
+  }
+  return glob_range(glob_iterator(first), glob_iterator(last));
+}
+
+template <typename Container>
+path_map<Container>::glob_iterator::glob_iterator(glob_type traversal)
+    : traversal_(std::move(traversal)) {}
+
+template <typename Container>
+typename path_map<Container>::entry
+path_map<Container>::glob_iterator::dereference() const {
+  return entry{traversal_.path(), traversal_->second};
+}
+
+template <typename Container>
+void path_map<Container>::glob_iterator::increment() {
+  ++traversal_;
+}
+
+template <typename Container>
+bool path_map<Container>::glob_iterator::equal(
+    const glob_iterator& other) const {
+  return traversal_ == other.traversal_;
+}
+
+template <typename Container>
+path_map<Container>::entry_iterator::entry_iterator(
+    traversal_type traversal,
+    std::vector<const typename Container::key_type*> prefix)
+    : traversal_(std::move(traversal)),
+      path_(std::move(prefix)),
+      prefix_size_(path_.size()) {
+  update();
+}
+
+template <typename Container>
+typename path_map<Container>::entry
+path_map<Container>::entry_iterator::dereference() const {
+  return entry{path_view<Container>(path_.data(), path_.size()),
+               traversal_->second};
+}
+
+template <typename Container>
+void path_map<Container>::entry_iterator::increment() {
+  ++traversal_;
+  update();
+}
+
+template <typename Container>
+bool path_map<Container>::entry_iterator::equal(
+    const entry_iterator& other) const {
+  return traversal_ == other.traversal_;
+}
+
+template <typename Container>
+void path_map<Container>::entry_iterator::update() {
+  if (traversal_.position() == traversal_.vertices().end()) {
+    return;
+  }
+  auto depth = traversal_.depth();
+  if (depth == 0) {  // the traversal root, which the prefix leads to
+    path_.resize(prefix_size_);
+    return;
+  }
+  path_.resize(prefix_size_ + depth - 1);
+  path_.push_back(&traversal_->first);
+}
+
 template <typename Container>
 typename path_map<Container>::iterator path_map<Container>::search(
     const key_type& p) const {
-  if (root_ == nodes().end()) {
-    return end();
+  auto traversal = traversal_type(nodes(), root_);
+  auto history = std::vector<value_type>();
+  auto path = key_type();
+  for (const auto& segment : p) {  // descend one level per path segment
+    auto parent = traversal.position();
+    if (!traversal.descend(segment)) {
+      break;
+    }
+    if (!path.empty()) {  // record ancestors so the result can be rewound
+      history.emplace_back(path, parent->second);
+    }
+    path.push_back(segment);
   }
-  key_type path = key_type{root_->first};  // pre-pend root to search path
-  path.insert(path.end(), p.begin(), p.end());
-  auto predicate = [&path](const auto& e) -> bool {
-    return e.is_root() || path.end() != std::search(path.begin(), path.end(),
-                                                    e.begin(), e.end());
-  };
-  auto first = traversal_type(nodes(), root_, predicate);
-  auto last = first.end();
-  first = first == last ? first : ++first;  // don't include root in results
-  auto first_transformer = transform_type(first, decoder{nodes()});
-  auto last_transformer = transform_type(last, decoder{nodes()});
-  auto begin = iterator(first_transformer);
-  auto end = iterator(last_transformer);
-  auto result = begin;
-  for (auto it = begin; it != end; ++it) {
-    result = it;
+  if (path.empty()) {
+    return end();
   }
-  return result;
+  path.pop_back();  // the decoder appends the matched segment itself
+  auto transformer = transform_type(traversal, decoder{nodes(), path});
+  return iterator(transformer, std::move(history));
 }
 
 template <typename Container>
@@ -201,39 +448,120 @@ path_map<Container>::insert(const value_type& value) {
   auto result = std::make_pair(search(value.first), false);
   result.second = result.first == end() || value.first != result.first->first;
   if (!result.second) return result;  // return existing element at path
-  auto prit = value.first.rbegin();   // parent reverse iterator
-  auto chit = nodes().end();          // child iterator
-  auto node = value.second;
-  auto inserted = false;
-  std::tie(chit, inserted) = insert_or_assign(*prit++, node);
-  for (auto rend = value.first.rend(); prit != rend; ++prit) {
-    // loop backwards through path, inserting parents where they don't exist
-    if (result.first != end()) {                  // search results not empty
-      if (result.first->first.back() == *prit) {  // match exists at this level
-        node = result.first->second;  // Copy existing node for this link
-        if (chit != nodes().end()) {  // add child link if missing
-          node.insert(chit->first);
-        }
-        --result.first;  // move up a level in search results
+  merge(&value, &value + 1, false);
+  result.first = search(value.first);
+  return result;
+}
+
+template <typename Container>
+template <typename InputIt>
+typename path_map<Container>::size_type path_map<Container>::load(
+    InputIt first, InputIt last) {
+  return merge(first, last, false);
+}
+
+template <typename Container>
+template <typename ForwardIt>
+typename path_map<Container>::size_type path_map<Container>::insert(
+    ForwardIt first, ForwardIt last) {
+  return merge_batch(first, last, false);
+}
+
+template <typename Container>
+template <typename ForwardIt>
+typename path_map<Container>::size_type path_map<Container>::insert_or_assign(
+    ForwardIt first, ForwardIt last) {
+  return merge_batch(first, last, true);
+}
+
+template <typename Container>
+template <typename ForwardIt>
+typename path_map<Container>::size_type path_map<Container>::merge_batch(
+    ForwardIt first, ForwardIt last, bool assign) {
+  using pair_type = typename std::iterator_traits<ForwardIt>::value_type;
+  auto batch = std::vector<const pair_type*>();
+  for (; first != last; ++first) {
+    batch.push_back(&*first);
+  }
+  // stable, so that repeated paths are merged in the order given
+  std::stable_sort(batch.begin(), batch.end(),
+                   [](const pair_type* lhs, const pair_type* rhs) {
+                     return lhs->first < rhs->first;
+                   });
+  return merge(boost::make_indirect_iterator(batch.begin()),
+               boost::make_indirect_iterator(batch.end()), assign);
+}
+
+template <typename Container>
+template <typename InputIt>
+typename path_map<Container>::size_type path_map<Container>::merge(
+    InputIt first, InputIt last, bool assign) {
+  using container_key = typename Container::key_type;
+  struct level {
+    container_key key;
+    mapped_type node;  // pending, with the links of the levels below it
+  };
+  auto levels = std::vector<level>();  // the open path, from the root down
+  if (root_ == nodes().end()) {
+    levels.push_back(level{container_key{}, mapped_type()});
+  } else {
+    levels.push_back(level{root_->first, root_->second});
+  }
+  auto close = [this, &levels](std::size_t size) {
+    for (; levels.size() > size; levels.pop_back()) {
+      insert_or_assign(levels.back().key, levels.back().node);
+    }
+  };
+  auto opened = false;
+  auto count = size_type(0);
+  for (; first != last; ++first) {
+    const auto& [path, node] = *first;
+    if (path.empty()) {
+      continue;
+    }
+    auto common = std::size_t(0);  // segments shared with the open path
+    while (common < path.size() && common + 1 < levels.size() &&
+           levels[common + 1].key == path[common]) {
+      ++common;
+    }
+    if (common == path.size()) {  // the path is open, so is already present
+      if (assign) {
+        auto value = node;
+        const auto& pending = levels[common].node;
+        value.insert(pending.begin(), pending.end());
+        levels[common].node = std::move(value);
       }
-    } else {                        // missing node at current level
-      node = mapped_type();         // create empty node
-      if (chit != nodes().end()) {  // add link from parent to child
-        node.insert(chit->first);
+      continue;
+    }
+    close(common + 1);
+    for (auto i = common; i < path.size(); ++i) {
+      const auto& segment = path[i];
+      auto existing = nodes().find(segment);
+      auto linked = !levels.back().node.insert(segment).second &&
+                    existing != nodes().end();
+      auto is_last = i + 1 == path.size();
+      if (is_last && (!linked || assign)) {
+        auto value = node;
+        if (linked) {  // keep the children of the path being assigned
+          value.insert(existing->second.begin(), existing->second.end());
+        } else {
+          ++count;
+        }
+        levels.push_back(level{segment, std::move(value)});
+      } else if (existing != nodes().end()) {
+        levels.push_back(level{segment, existing->second});
+      } else {
+        levels.push_back(level{segment, mapped_type()});
       }
-    }  // upsert parent node and mark as child for next iteration
-    std::tie(chit, inserted) = insert_or_assign(*prit, node);
+    }
+    opened = true;
   }
-  node = mapped_type{};
-  if (root_ != nodes().end()) {
-    node = root_->second;
-  }  // create or update root node to point to first element in path
-  node.insert(chit->first);
-  using container_key = typename Container::key_type;
-  auto link = root_ == nodes().end() ? container_key{} : root_->first;
-  std::tie(root_, inserted) = insert_or_assign(link, node);
-  result.first = search(value.first);
-  return result;
+  if (!opened) {
+    return count;
+  }
+  close(1);
+  root_ = insert_or_assign(levels.front().key, levels.front().node).first;
+  return count;
 }
 
 template <typename Container>
@@ -3,10 +3,15 @@
 
 namespace vertex {
 
-template <typename Link, typename T = void>
-class pod_node : public node<pod_node<Link, T>, Link, T> {
+template <typename Link, typename T = void,
+          typename Container = std::vector<Link>,
+          typename Ordering = unordered_links>
+class pod_node
+    : public node<pod_node<Link, T, Container, Ordering>, Link, T, Container,
+                  Ordering> {
  public:
-  using base_type = node<pod_node<Link, T>, Link, T>;
+  using base_type = node<pod_node<Link, T, Container, Ordering>, Link, T,
+                         Container, Ordering>;
   using element_type = typename base_type::element_type;
   using container_type = typename base_type::container_type;
   using value_type = typename base_type::value_type;
@@ -15,7 +20,9 @@ class pod_node : public node<pod_node<Link, T>, Link, T> {
   explicit pod_node(element_type data) : data_(std::move(data)) {}
 
   pod_node(element_type data, container_type links)
-      : links_(std::move(links)), data_(std::move(data)) {}
+      : links_(std::move(links)), data_(std::move(data)) {
+    base_type::order_links();
+  }
 
   container_type& get_links() { return links_; }
   element_type& get_element() { return data_; };
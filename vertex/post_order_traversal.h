@@ -3,44 +3,58 @@
 #include <stack>
 
 namespace vertex {
-template <typename Container>
+/** Post-order traversal of binary vertices. The stack holds the path from
+ * the root, so its height gives the depth of each vertex; children below
+ * max_depth are not pushed */
+template <typename Container,
+          typename Predicate = predicate_function<Container>,
+          typename Visited = no_visited_set>
 class post_order_traversal
-    : public traversal<Container, post_order_traversal<Container>> {
+    : public traversal<Container,
+                       post_order_traversal<Container, Predicate, Visited>,
+                       Predicate, Visited> {
  public:
-  using base_type = traversal<Container, post_order_traversal<Container>>;
+  using base_type =
+      traversal<Container, post_order_traversal, Predicate, Visited>;
   using base_type::is_traversable;
   using base_type::position;
   using base_type::root;
   using base_type::vertices;
   using typename base_type::predicate_type;
+  using typename base_type::size_type;
 
   post_order_traversal(
       const Container& vertices, typename Container::const_iterator root,
-      predicate_type predicate = typename base_type::unconditional_traversal());
+      predicate_type predicate = typename base_type::unconditional_traversal(),
+      size_type max_depth = base_type::unlimited);
 
   bool traverseRight();
   bool traverseLeft();
   bool next();
 
  private:
-  std::stack<typename base_type::edge_type> to_visit_;
+  friend base_type;
+
+  copy_on_write<std::stack<typename base_type::edge_type>> to_visit_;
   typename base_type::vertex_iterator prev_pos_;
 };
 
-template <typename Container>
-post_order_traversal<Container>::post_order_traversal(
+template <typename Container, typename Predicate, typename Visited>
+post_order_traversal<Container, Predicate, Visited>::post_order_traversal(
     const Container& vertices, typename Container::const_iterator root,
-    typename post_order_traversal<Container>::predicate_type predicate)
-    : base_type(vertices, root, predicate), prev_pos_(vertices.end()) {
+    predicate_type predicate, size_type max_depth)
+    : base_type(vertices, root, predicate, max_depth),
+      prev_pos_(vertices.end()) {
   if (position() != base_type::vertices().end()) {
     auto e = edge<Container>::root(position()->first);
-    to_visit_.push(e);
+    to_visit_.mutate().push(e);
     next();
   }
 }
 
-template <typename Container>
-bool post_order_traversal<Container>::traverseLeft() {
+template <typename Container, typename Predicate, typename Visited>
+bool post_order_traversal<Container, Predicate, Visited>::traverseLeft() {
+  auto& to_visit = to_visit_.mutate();
   auto moved = false;
   while (position()->second.size() ==
          2) {  // traversal to bottom of left branch
@@ -49,31 +63,37 @@ bool post_order_traversal<Container>::traverseLeft() {
     auto left_child = vertices().find(left_key);
     auto left_edge = edge<Container>(position()->first, left_key);
     if (right_child == prev_pos_ || left_child == prev_pos_ ||
-        left_child == vertices().end() || !is_traversable(left_edge)) {
+        left_child == vertices().end() ||
+        to_visit.size() > base_type::max_depth() ||
+        !is_traversable(left_edge) ||
+        !base_type::enter(left_child)) {
       moved = false;
       break;
     } else {
-      to_visit_.push(left_edge);
+      to_visit.push(left_edge);
       base_type::position(left_child);
       moved = true;
     }
   }
   if (moved) {
-    to_visit_.pop();
+    to_visit.pop();
   }
   return moved;
 }
 
-template <typename Container>
-bool post_order_traversal<Container>::traverseRight() {
+template <typename Container, typename Predicate, typename Visited>
+bool post_order_traversal<Container, Predicate, Visited>::traverseRight() {
+  auto& to_visit = to_visit_.mutate();
   auto moved = false;
   if (position()->second.size() == 2) {  // traverse right branch
     auto child_key = *(++position()->second.begin());
     auto child_vertex = vertices().find(child_key);
     auto child_edge = edge<Container>(position()->first, child_key);
     if (child_vertex != vertices().end() && child_vertex != prev_pos_ &&
-        is_traversable(child_edge)) {  // don't move to right child if null
-      to_visit_.push(child_edge);
+        to_visit.size() <= base_type::max_depth() &&
+        is_traversable(child_edge) &&
+        base_type::enter(child_vertex)) {  // don't move to right child if null
+      to_visit.push(child_edge);
       base_type::position(child_vertex);
       moved = true;
     }
@@ -81,13 +101,14 @@ bool post_order_traversal<Container>::traverseRight() {
   return moved;
 }
 
-template <typename Container>
-bool post_order_traversal<Container>::next() {
+template <typename Container, typename Predicate, typename Visited>
+bool post_order_traversal<Container, Predicate, Visited>::next() {
+  auto& to_visit = to_visit_.mutate();
   auto moved = false;
   prev_pos_ = position();
-  while (!to_visit_.empty()) {
+  while (!to_visit.empty()) {
     if (!moved) {
-      auto edge = to_visit_.top();
+      auto edge = to_visit.top();
       base_type::position(vertices().find(edge.target()));
       moved = true;
     } else if (traverseLeft()) {
@@ -95,11 +116,13 @@ bool post_order_traversal<Container>::next() {
       break;
     } else if (traverseRight()) {
       moved = true;
-    } else if (!to_visit_.empty()) {
-      to_visit_.pop();
+    } else if (!to_visit.empty()) {
+      to_visit.pop();
       break;
     }
   }
+  // the stack now holds the ancestors of the position
+  base_type::position(position(), to_visit.size());
   return moved;
 }
 
@@ -1,95 +1,161 @@
 #pragma once
 
+#include <vertex/prefetch.h>
 #include <vertex/traversal.h>
-#include <algorithm>
-#include <stack>
+#include <iterator>
+#include <vector>
 
 namespace vertex {
-template <typename Container>
+
+/** Pre-order traversal. Each frame of the stack holds a vertex on the path
+ * from the root and the cursor of its next child, so that every link is
+ * resolved once per visit of its parent. The depth of the position is the
+ * height of the stack, and frames at max_depth are not expanded. The
+ * children of each frame are prefetched up to lookahead links ahead of its
+ * cursor */
+template <typename Container,
+          typename Predicate = predicate_function<Container>,
+          typename Visited = no_visited_set>
 class pre_order_traversal
-    : public traversal<Container, pre_order_traversal<Container>> {
+    : public traversal<Container,
+                       pre_order_traversal<Container, Predicate, Visited>,
+                       Predicate, Visited> {
  public:
-  using base_type = traversal<Container, pre_order_traversal<Container>>;
+  using base_type =
+      traversal<Container, pre_order_traversal, Predicate, Visited>;
   using base_type::is_traversable;
   using base_type::position;
   using base_type::root;
   using base_type::vertices;
   using typename base_type::predicate_type;
+  using typename base_type::size_type;
 
   pre_order_traversal();
 
   pre_order_traversal(
       const Container& vertices, typename Container::const_iterator root,
-      predicate_type predicate = typename base_type::unconditional_traversal());
+      predicate_type predicate = typename base_type::unconditional_traversal(),
+      size_type max_depth = base_type::unlimited);
 
   bool next();
 
+  /** Moves directly to the child of the current position with the given key,
+   * as though the traversal had reached it in pre-order.
+   * @return false, leaving the position unchanged, if the current vertex has
+   * no such traversable child or is at max_depth */
+  bool descend(const typename Container::key_type& key);
+
  private:
-  using vertex_type = typename Container::mapped_type;
-  using link_type = typename vertex_type::container_type::value_type;
+  friend base_type;
+
+  using vertex_iterator = typename base_type::vertex_iterator;
+  using link_iterator =
+      typename Container::mapped_type::container_type::const_iterator;
+
+  struct frame {
+    vertex_iterator vertex;
+    link_iterator next;          // the next child link to visit
+    link_iterator ahead;         // the next child link to prefetch
+    std::size_t prefetched = 0;  // links in [next, ahead)
+  };
 
-  bool traverse(link_type link);
+  void push(const vertex_iterator& vertex);
 
-  std::stack<typename base_type::edge_type> to_visit_;
-  typename base_type::vertex_iterator prev_pos_;
+  /** Advances the cursor of top, keeping lookahead links prefetched */
+  void advance(frame& top);
+
+  copy_on_write<std::vector<frame>> to_visit_;
 };
 
-template <typename Container>
-pre_order_traversal<Container>::pre_order_traversal() {}
+template <typename Container, typename Predicate, typename Visited>
+pre_order_traversal<Container, Predicate, Visited>::pre_order_traversal() {}
 
-template <typename Container>
-pre_order_traversal<Container>::pre_order_traversal(
+template <typename Container, typename Predicate, typename Visited>
+pre_order_traversal<Container, Predicate, Visited>::pre_order_traversal(
     const Container& vertices, typename Container::const_iterator root,
-    predicate_type predicate)
-    : base_type(vertices, root, predicate), prev_pos_(vertices.end()) {
+    predicate_type predicate, size_type max_depth)
+    : base_type(vertices, root, predicate, max_depth) {
   if (position() != base_type::vertices().end()) {
-    auto e = edge<Container>::root(position()->first);
-    to_visit_.push(e);
+    push(position());
   }
 }
 
-template <typename Container>
-bool pre_order_traversal<Container>::traverse(link_type link) {
-  auto& node = position()->second;
-  auto moved = false;
-  auto child = vertices().find(link);
-  auto e = edge<Container>(position()->first, link);
-  auto child_it = node.find(prev_pos_->first);
-  auto link_it = node.find(link);
-  if ((child_it == node.end() || link_it > child_it) &&
-      child != vertices().end() && is_traversable(e)) {
-    base_type::position(child);
-    moved = true;
+template <typename Container, typename Predicate, typename Visited>
+void pre_order_traversal<Container, Predicate, Visited>::push(
+    const vertex_iterator& vertex) {
+  auto& to_visit = to_visit_.mutate();
+  auto first = vertex->second.begin();
+  to_visit.push_back(frame{vertex, first, first});
+  base_type::position(vertex, to_visit.size() - 1);
+  if (to_visit.size() <= base_type::max_depth()) {
+    auto& top = to_visit.back();
+    for (auto end = vertex->second.end();
+         top.ahead != end && top.prefetched < lookahead; ++top.prefetched) {
+      vertex::prefetch(vertices(), *top.ahead++);
+    }
+  }
+}
+
+template <typename Container, typename Predicate, typename Visited>
+void pre_order_traversal<Container, Predicate, Visited>::advance(frame& top) {
+  ++top.next;
+  if (top.prefetched == 0) {  // the window was empty
+    top.ahead = top.next;
+  } else {
+    --top.prefetched;
+  }
+  if (top.ahead != top.vertex->second.end()) {
+    vertex::prefetch(vertices(), *top.ahead++);
+    ++top.prefetched;
+  }
+}
+
+template <typename Container, typename Predicate, typename Visited>
+bool pre_order_traversal<Container, Predicate, Visited>::descend(
+    const typename Container::key_type& key) {
+  if (!to_visit_ || to_visit_.get().empty() ||
+      position() == vertices().end() ||
+      to_visit_.get().size() > base_type::max_depth()) {
+    return false;
+  }
+  auto& top = to_visit_.mutate().back();
+  auto link = top.vertex->second.find(key);
+  if (link == top.vertex->second.end()) {
+    return false;
+  }
+  auto child = vertices().find(key);
+  if (child == vertices().end() || !is_traversable(top.vertex->first, key) ||
+      !base_type::enter(child)) {
+    return false;
   }
-  return moved;
+  top.next = link;  // resume after this child on the way back up
+  top.ahead = link;
+  top.prefetched = 0;
+  advance(top);
+  push(child);
+  return true;
 }
 
-template <typename Container>
-bool pre_order_traversal<Container>::next() {
-  auto moved = false;
-  prev_pos_ = position();
-  while (!to_visit_.empty()) {
-    auto source = position();
-    for (const auto& link : position()->second) {
-      if (traverse(link)) {
-        moved = true;
-        break;
-      }
+template <typename Container, typename Predicate, typename Visited>
+bool pre_order_traversal<Container, Predicate, Visited>::next() {
+  auto& to_visit = to_visit_.mutate();
+  while (!to_visit.empty()) {
+    auto& top = to_visit.back();
+    if (top.next == top.vertex->second.end() ||
+        to_visit.size() > base_type::max_depth()) {
+      to_visit.pop_back();
+      continue;
     }
-    if (!moved) {
-      to_visit_.pop();
-      prev_pos_ = position();
-      if (!to_visit_.empty()) {
-        auto edge = to_visit_.top();
-        base_type::position(vertices().find(edge.target()));
-      }
-    } else {
-      auto e = edge<Container>(source->first, position()->first);
-      to_visit_.push(e);
-      break;
+    const auto& link = *top.next;
+    advance(top);
+    auto child = vertices().find(link);
+    if (child != vertices().end() && is_traversable(top.vertex->first, link) &&
+        base_type::enter(child)) {
+      push(child);
+      return true;
     }
   }
-  return moved;
+  return false;
 }
 
 }  // namespace vertex
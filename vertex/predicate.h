@@ -1,11 +1,45 @@
 #pragma once
 #include <vertex/edge.h>
 #include <cstdint>
+#include <functional>
 #include <map>
+#include <type_traits>
 #include <utility>
 
 namespace vertex {
 
+/** Predicate which traverses every edge. Used as the Predicate of a
+ * traversal, it compiles away, and no edges are constructed to test it */
+template <typename Container>
+struct unconditional {
+  constexpr bool operator()(const edge<Container>& /*value*/) const {
+    return true;
+  }
+};
+
+/** Type-erased Predicate, which accepts any callable on edges at the cost of
+ * an indirect call per edge */
+template <typename Container>
+using predicate_function = std::function<bool(const edge<Container>&)>;
+
+/** True if Predicate is the unconditional predicate of Container */
+template <typename Container, typename Predicate>
+constexpr bool is_unconditional_v =
+    std::is_same_v<Predicate, unconditional<Container>>;
+
+/** True if copies of a traversal may share one Predicate, which they call
+ * through a const reference. Only a predicate without state that a call
+ * could change qualifies: unconditional, and captureless or trivially
+ * copyable callables. A predicate_function may wrap a stateful functor, so
+ * each copy which advances clones it */
+template <typename Container, typename Predicate>
+constexpr bool is_shareable_predicate_v =
+    std::is_invocable_r_v<bool, const Predicate&, const edge<Container>&> &&
+    (std::is_empty_v<Predicate> || std::is_trivially_copyable_v<Predicate>);
+
+/** Predicate which stops at max_depth, recording the depth of every source
+ * it has seen. Traversals prune by depth without this table when given a
+ * max_depth argument */
 template <typename Container>
 class MaxDepthPredicate {
  public:
@@ -0,0 +1 @@
+#include <vertex/prefetch.h>
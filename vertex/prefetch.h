@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace vertex {
+
+/** Number of keys the traversals look up ahead of the one they need */
+constexpr std::size_t lookahead = 8;
+
+/** Detects Container::prefetch(key) */
+template <typename Container, typename = void>
+struct has_prefetch : std::false_type {};
+
+template <typename Container>
+struct has_prefetch<
+    Container, std::void_t<decltype(std::declval<const Container&>().prefetch(
+                   std::declval<const typename Container::key_type&>()))>>
+    : std::true_type {};
+
+/** Detects Container::find_many(first, last, out) */
+template <typename Container, typename = void>
+struct has_find_many : std::false_type {};
+
+template <typename Container>
+struct has_find_many<
+    Container,
+    std::void_t<decltype(std::declval<const Container&>().find_many(
+        std::declval<const typename Container::key_type*>(),
+        std::declval<const typename Container::key_type*>(),
+        std::declval<typename Container::const_iterator*>()))>>
+    : std::true_type {};
+
+/** Hints to the processor that address will soon be read */
+inline void prefetch_memory(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address);
+#else
+  (void)address;
+#endif
+}
+
+/** Hints that key will soon be looked up in vertices. A store which can
+ * start a look-up early, such as stable_hash_map loading its table into
+ * cache or a paged store reading ahead, provides prefetch(key); for any
+ * other Container this does nothing */
+template <typename Container>
+void prefetch(const Container& vertices,
+              const typename Container::key_type& key);
+
+/** Looks up each key of [first, last) in vertices, writing the resulting
+ * const_iterators, or end() for missing keys, to out in order.
+ *
+ * Uses Container::find_many where present, which may overlap the look-ups
+ * of a batch. Otherwise each key is found in turn, after prefetching the
+ * keys up to lookahead places ahead of it.
+ * @return out, past the last iterator written */
+template <typename Container, typename ForwardIt, typename OutputIt>
+OutputIt find_many(const Container& vertices, ForwardIt first, ForwardIt last,
+                   OutputIt out);
+
+template <typename Container>
+void prefetch(const Container& vertices,
+              const typename Container::key_type& key) {
+  if constexpr (has_prefetch<Container>::value) {
+    vertices.prefetch(key);
+  } else {
+    (void)vertices;
+    (void)key;
+  }
+}
+
+template <typename Container, typename ForwardIt, typename OutputIt>
+OutputIt find_many(const Container& vertices, ForwardIt first, ForwardIt last,
+                   OutputIt out) {
+  if constexpr (has_find_many<Container>::value) {
+    return vertices.find_many(first, last, out);
+  } else {
+    auto ahead = first;
+    for (std::size_t i = 0; i < lookahead && ahead != last; ++i, ++ahead) {
+      prefetch(vertices, *ahead);
+    }
+    for (; first != last; ++first) {
+      if (ahead != last) {
+        prefetch(vertices, *ahead++);
+      }
+      *out++ = vertices.find(*first);
+    }
+    return out;
+  }
+}
+
+}  // namespace vertex
@@ -0,0 +1 @@
+#include <vertex/small_vector.h>
@@ -0,0 +1,487 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace vertex {
+
+/** A std::vector-like sequence which stores up to N elements inline, and only
+ * allocates from the heap once it grows beyond N.
+ *
+ * Intended as the Container of a node, where most vertices have a handful of
+ * links: small nodes then need no allocation, and copying them is a copy of
+ * the inline buffer. */
+template <typename T, std::size_t N>
+class small_vector {
+ public:
+  static_assert(N > 0, "small_vector requires at least one inline slot");
+
+  using value_type = T;
+  using allocator_type = std::allocator<T>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+  using iterator = pointer;
+  using const_iterator = const_pointer;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  /** Creates an empty vector using only inline storage */
+  small_vector() noexcept;
+
+  /** Creates a vector holding a copy of each of the values */
+  small_vector(std::initializer_list<value_type> values);
+
+  /** Creates a vector holding a copy of each element of [first, last) */
+  template <typename InputIt,
+            typename = typename std::iterator_traits<InputIt>::value_type>
+  small_vector(InputIt first, InputIt last);
+
+  small_vector(const small_vector& other);
+  small_vector(small_vector&& other) noexcept(
+      std::is_nothrow_move_constructible_v<T>);
+  small_vector& operator=(const small_vector& other);
+  small_vector& operator=(small_vector&& other) noexcept(
+      std::is_nothrow_move_constructible_v<T>);
+  ~small_vector();
+
+  iterator begin() noexcept;
+  iterator end() noexcept;
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+  const_iterator cbegin() const noexcept;
+  const_iterator cend() const noexcept;
+  reverse_iterator rbegin() noexcept;
+  reverse_iterator rend() noexcept;
+  const_reverse_iterator rbegin() const noexcept;
+  const_reverse_iterator rend() const noexcept;
+
+  reference operator[](size_type pos);
+  const_reference operator[](size_type pos) const;
+  reference front();
+  const_reference front() const;
+  reference back();
+  const_reference back() const;
+  pointer data() noexcept;
+  const_pointer data() const noexcept;
+
+  [[nodiscard]] bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type capacity() const noexcept;
+
+  /** Returns the number of elements which can be stored without allocating */
+  static constexpr size_type inline_capacity() noexcept;
+
+  /** Returns true if the elements are stored in the inline buffer */
+  bool is_inline() const noexcept;
+
+  /** Ensures capacity for at least n elements, moving to the heap if needed */
+  void reserve(size_type n);
+
+  /** Destroys all elements. Heap storage, if any, is retained */
+  void clear() noexcept;
+
+  /** Inserts value before pos */
+  iterator insert(const_iterator pos, const value_type& value);
+
+  /** Inserts value before pos */
+  iterator insert(const_iterator pos, value_type&& value);
+
+  /** Inserts the elements of [first, last) before pos */
+  template <typename InputIt,
+            typename = typename std::iterator_traits<InputIt>::value_type>
+  iterator insert(const_iterator pos, InputIt first, InputIt last);
+
+  /** Removes the element at pos */
+  iterator erase(const_iterator pos);
+
+  /** Removes the elements in the range [first, last) */
+  iterator erase(const_iterator first, const_iterator last);
+
+  void push_back(const value_type& value);
+  void push_back(value_type&& value);
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args);
+
+  void pop_back();
+
+  bool operator==(const small_vector& rhs) const;
+  bool operator!=(const small_vector& rhs) const;
+  bool operator<(const small_vector& rhs) const;
+
+ private:
+  pointer inline_data() noexcept;
+
+  /** Moves the elements to storage of the given capacity */
+  void reallocate(size_type capacity);
+
+  /** Returns the capacity to grow to when one more element is required */
+  size_type grow_capacity() const noexcept;
+
+  /** Releases heap storage, if any, reverting to the inline buffer */
+  void release() noexcept;
+
+  pointer data_;
+  size_type size_;
+  size_type capacity_;
+  alignas(T) unsigned char buffer_[sizeof(T) * N];
+};
+
+template <typename T, std::size_t N>
+small_vector<T, N>::small_vector() noexcept
+    : data_(inline_data()), size_(0), capacity_(N) {}
+
+template <typename T, std::size_t N>
+small_vector<T, N>::small_vector(std::initializer_list<value_type> values)
+    : small_vector(values.begin(), values.end()) {}
+
+template <typename T, std::size_t N>
+template <typename InputIt, typename>
+small_vector<T, N>::small_vector(InputIt first, InputIt last)
+    : small_vector() {
+  insert(end(), first, last);
+}
+
+template <typename T, std::size_t N>
+small_vector<T, N>::small_vector(const small_vector& other) : small_vector() {
+  reserve(other.size_);
+  std::uninitialized_copy(other.begin(), other.end(), data_);
+  size_ = other.size_;
+}
+
+template <typename T, std::size_t N>
+small_vector<T, N>::small_vector(small_vector&& other) noexcept(
+    std::is_nothrow_move_constructible_v<T>)
+    : small_vector() {
+  *this = std::move(other);
+}
+
+template <typename T, std::size_t N>
+small_vector<T, N>& small_vector<T, N>::operator=(const small_vector& other) {
+  if (this != &other) {
+    clear();
+    reserve(other.size_);
+    std::uninitialized_copy(other.begin(), other.end(), data_);
+    size_ = other.size_;
+  }
+  return *this;
+}
+
+template <typename T, std::size_t N>
+small_vector<T, N>& small_vector<T, N>::operator=(
+    small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+  if (this != &other) {
+    clear();
+    if (other.is_inline()) {  // elements must be moved one by one
+      std::uninitialized_move(other.begin(), other.end(), data_);
+      size_ = other.size_;
+      other.clear();
+    } else {  // steal the heap allocation
+      release();
+      data_ = std::exchange(other.data_, other.inline_data());
+      size_ = std::exchange(other.size_, 0);
+      capacity_ = std::exchange(other.capacity_, N);
+    }
+  }
+  return *this;
+}
+
+template <typename T, std::size_t N>
+small_vector<T, N>::~small_vector() {
+  clear();
+  release();
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::begin() noexcept {
+  return data_;
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::end() noexcept {
+  return data_ + size_;
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::const_iterator small_vector<T, N>::begin() const
+    noexcept {
+  return data_;
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::const_iterator small_vector<T, N>::end() const
+    noexcept {
+  return data_ + size_;
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::const_iterator small_vector<T, N>::cbegin() const
+    noexcept {
+  return begin();
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::const_iterator small_vector<T, N>::cend() const
+    noexcept {
+  return end();
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::reverse_iterator
+small_vector<T, N>::rbegin() noexcept {
+  return reverse_iterator(end());
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::reverse_iterator
+small_vector<T, N>::rend() noexcept {
+  return reverse_iterator(begin());
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::const_reverse_iterator
+small_vector<T, N>::rbegin() const noexcept {
+  return const_reverse_iterator(end());
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::const_reverse_iterator
+small_vector<T, N>::rend() const noexcept {
+  return const_reverse_iterator(begin());
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::reference small_vector<T, N>::operator[](
+    size_type pos) {
+  return data_[pos];
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::const_reference small_vector<T, N>::operator[](
+    size_type pos) const {
+  return data_[pos];
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::reference small_vector<T, N>::front() {
+  return data_[0];
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::const_reference small_vector<T, N>::front()
+    const {
+  return data_[0];
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::reference small_vector<T, N>::back() {
+  return data_[size_ - 1];
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::const_reference small_vector<T, N>::back() const {
+  return data_[size_ - 1];
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::pointer small_vector<T, N>::data() noexcept {
+  return data_;
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::const_pointer small_vector<T, N>::data() const
+    noexcept {
+  return data_;
+}
+
+template <typename T, std::size_t N>
+bool small_vector<T, N>::empty() const noexcept {
+  return size_ == 0;
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::size_type small_vector<T, N>::size() const
+    noexcept {
+  return size_;
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::size_type small_vector<T, N>::capacity() const
+    noexcept {
+  return capacity_;
+}
+
+template <typename T, std::size_t N>
+constexpr typename small_vector<T, N>::size_type
+small_vector<T, N>::inline_capacity() noexcept {
+  return N;
+}
+
+template <typename T, std::size_t N>
+bool small_vector<T, N>::is_inline() const noexcept {
+  return data_ == reinterpret_cast<const_pointer>(buffer_);
+}
+
+template <typename T, std::size_t N>
+void small_vector<T, N>::reserve(size_type n) {
+  if (n > capacity_) {
+    reallocate(n);
+  }
+}
+
+template <typename T, std::size_t N>
+void small_vector<T, N>::clear() noexcept {
+  std::destroy(begin(), end());
+  size_ = 0;
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::insert(
+    const_iterator pos, const value_type& value) {
+  return insert(pos, value_type(value));  // copy first in case of aliasing
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::insert(
+    const_iterator pos, value_type&& value) {
+  auto index = pos - begin();
+  if (size_ == capacity_) {
+    reallocate(grow_capacity());
+  }
+  auto position = begin() + index;
+  if (position == end()) {
+    ::new (static_cast<void*>(end())) value_type(std::move(value));
+  } else {  // shuffle the tail along by one
+    ::new (static_cast<void*>(end())) value_type(std::move(back()));
+    std::move_backward(position, end() - 1, end());
+    *position = std::move(value);
+  }
+  ++size_;
+  return position;
+}
+
+template <typename T, std::size_t N>
+template <typename InputIt, typename>
+typename small_vector<T, N>::iterator small_vector<T, N>::insert(
+    const_iterator pos, InputIt first, InputIt last) {
+  auto index = pos - begin();
+  auto old_size = size_;
+  using category = typename std::iterator_traits<InputIt>::iterator_category;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+    reserve(size_ + static_cast<size_type>(std::distance(first, last)));
+  }
+  for (; first != last; ++first) {
+    emplace_back(*first);
+  }
+  std::rotate(begin() + index, begin() + old_size, end());
+  return begin() + index;
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::erase(
+    const_iterator pos) {
+  return erase(pos, pos + 1);
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::iterator small_vector<T, N>::erase(
+    const_iterator first, const_iterator last) {
+  auto position = begin() + (first - begin());
+  if (first != last) {
+    auto tail = std::move(position + (last - first), end(), position);
+    std::destroy(tail, end());
+    size_ = static_cast<size_type>(tail - begin());
+  }
+  return position;
+}
+
+template <typename T, std::size_t N>
+void small_vector<T, N>::push_back(const value_type& value) {
+  emplace_back(value);
+}
+
+template <typename T, std::size_t N>
+void small_vector<T, N>::push_back(value_type&& value) {
+  emplace_back(std::move(value));
+}
+
+template <typename T, std::size_t N>
+template <typename... Args>
+typename small_vector<T, N>::reference small_vector<T, N>::emplace_back(
+    Args&&... args) {
+  if (size_ == capacity_) {  // construct before moving in case of aliasing
+    auto value = value_type(std::forward<Args>(args)...);
+    reallocate(grow_capacity());
+    ::new (static_cast<void*>(end())) value_type(std::move(value));
+  } else {
+    ::new (static_cast<void*>(end())) value_type(std::forward<Args>(args)...);
+  }
+  ++size_;
+  return back();
+}
+
+template <typename T, std::size_t N>
+void small_vector<T, N>::pop_back() {
+  --size_;
+  std::destroy_at(end());
+}
+
+template <typename T, std::size_t N>
+bool small_vector<T, N>::operator==(const small_vector& rhs) const {
+  return std::equal(begin(), end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, std::size_t N>
+bool small_vector<T, N>::operator!=(const small_vector& rhs) const {
+  return !(*this == rhs);
+}
+
+template <typename T, std::size_t N>
+bool small_vector<T, N>::operator<(const small_vector& rhs) const {
+  return std::lexicographical_compare(begin(), end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::pointer small_vector<T, N>::inline_data() noexcept {
+  return reinterpret_cast<pointer>(buffer_);
+}
+
+template <typename T, std::size_t N>
+void small_vector<T, N>::reallocate(size_type capacity) {
+  auto allocator = allocator_type();
+  auto storage = std::allocator_traits<allocator_type>::allocate(allocator,
+                                                                 capacity);
+  std::uninitialized_move(begin(), end(), storage);
+  std::destroy(begin(), end());
+  release();
+  data_ = storage;
+  capacity_ = capacity;
+}
+
+template <typename T, std::size_t N>
+typename small_vector<T, N>::size_type small_vector<T, N>::grow_capacity()
+    const noexcept {
+  return capacity_ * 2;
+}
+
+template <typename T, std::size_t N>
+void small_vector<T, N>::release() noexcept {
+  if (!is_inline()) {
+    auto allocator = allocator_type();
+    std::allocator_traits<allocator_type>::deallocate(allocator, data_,
+                                                      capacity_);
+    data_ = inline_data();
+    capacity_ = N;
+  }
+}
+
+}  // namespace vertex
@@ -0,0 +1 @@
+#include <vertex/stable_hash_map.h>
@@ -0,0 +1,749 @@
+#pragma once
+
+#include <vertex/prefetch.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vertex {
+
+/** An unordered map with open-addressing look-up and stable elements.
+ *
+ * Elements live in fixed-size chunks which are never moved, so references
+ * and iterators remain valid across insertion and the erasure of other
+ * elements, as managed_container requires. Look-up probes a flat, linearly
+ * probed table of (hash, slot) pairs; growing the table only moves those
+ * pairs, never the elements. Erased slots are recycled by later insertions.
+ * A bitmap of occupied slots lets iteration skip erased slots a word at a
+ * time.
+ *
+ * Provides the subset of the std::unordered_map interface used by the
+ * traversals, path_map, array and managed_container. */
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class stable_hash_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const Key, T>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = std::allocator<value_type>;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+
+ private:
+  template <bool Const>
+  class basic_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = stable_hash_map::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+    using reference =
+        std::conditional_t<Const, const value_type&, value_type&>;
+    using map_pointer = std::conditional_t<Const, const stable_hash_map*,
+                                           stable_hash_map*>;
+
+    basic_iterator() = default;
+    basic_iterator(map_pointer map, size_type slot);
+
+    /** Converts an iterator to a const_iterator */
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    basic_iterator(const basic_iterator<false>& other);  // NOLINT
+
+    reference operator*() const;
+    pointer operator->() const;
+    basic_iterator& operator++();
+    basic_iterator operator++(int dummy);
+
+    /** Returns the slot holding the element */
+    size_type slot() const;
+
+    friend bool operator==(const basic_iterator& lhs,
+                           const basic_iterator& rhs) {
+      return lhs.slot_ == rhs.slot_;
+    }
+
+    friend bool operator!=(const basic_iterator& lhs,
+                           const basic_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class basic_iterator<!Const>;
+
+    map_pointer map_ = nullptr;
+    size_type slot_ = npos;
+  };
+
+ public:
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  stable_hash_map();
+
+  explicit stable_hash_map(size_type bucket_count, const Hash& hash = Hash(),
+                           const KeyEqual& equal = KeyEqual());
+
+  stable_hash_map(std::initializer_list<value_type> values);
+
+  stable_hash_map(const stable_hash_map& other);
+  stable_hash_map(stable_hash_map&& other) noexcept;
+  stable_hash_map& operator=(const stable_hash_map& other);
+  stable_hash_map& operator=(stable_hash_map&& other) noexcept;
+  ~stable_hash_map();
+
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+  [[nodiscard]] bool empty() const;
+  size_type size() const;
+
+  /** Returns the number of slots in the look-up table */
+  size_type bucket_count() const;
+
+  /** Returns the ratio of elements to look-up table slots */
+  float load_factor() const;
+
+  /** Grows the look-up table to hold at least n elements without rehashing */
+  void reserve(size_type n);
+
+  /** Erases all elements and releases their storage */
+  void clear();
+
+  iterator find(const key_type& key);
+  const_iterator find(const key_type& key) const;
+  size_type count(const key_type& key) const;
+
+  /** Loads the look-up table entries probed first for key into cache */
+  void prefetch(const key_type& key) const;
+
+  /** Finds each key of [first, last), writing a const_iterator per key to
+   * out. Keys are hashed and prefetched a batch at a time, so that the cache
+   * misses of a batch overlap rather than following one another */
+  template <typename ForwardIt, typename OutputIt>
+  OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) const;
+
+  /** Inserts a value constructed from args if its key is not present */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+
+  /** As emplace, returning only the position. The hint is unused and exists
+   * for interface compatibility with std::map, as in std::unordered_map */
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args);
+
+  /** Inserts value if its key is not present */
+  std::pair<iterator, bool> insert(const value_type& value);
+
+  /** Inserts a value constructed from key and args if key is not present */
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args);
+
+  /** Returns the value mapped to key, inserting a default value if needed */
+  mapped_type& operator[](const key_type& key);
+
+  /** Erases the element at pos, returning an iterator to the next element */
+  iterator erase(const_iterator pos);
+
+  /** Erases the element with the given key, if present */
+  size_type erase(const key_type& key);
+
+  /** Erases the element at pos without finding the next element, as in
+   * boost::unordered_map */
+  void quick_erase(const_iterator pos);
+
+  bool operator==(const stable_hash_map& rhs) const;
+  bool operator!=(const stable_hash_map& rhs) const;
+
+ private:
+  using slot_type = std::optional<value_type>;
+
+  /** An entry in the look-up table, which is empty when slot is npos */
+  struct bucket {
+    size_type hash = 0;
+    size_type slot = npos;
+  };
+
+  static constexpr size_type npos = std::numeric_limits<size_type>::max();
+  static constexpr size_type chunk_size = 64;
+  static constexpr size_type batch_size = 16;  // keys per find_many batch
+
+  using word_type = std::uint64_t;
+  static_assert(chunk_size == std::numeric_limits<word_type>::digits,
+                "a word of occupied_ must cover a chunk");
+
+  slot_type& at(size_type slot);
+  const slot_type& at(size_type slot) const;
+
+  /** Returns the first occupied slot at or after the given slot, or npos */
+  size_type next_occupied(size_type slot) const;
+
+  /** Returns the index of the lowest set bit of a non-zero word */
+  static size_type lowest_bit(word_type word);
+
+  /** Returns the position in the look-up table of key, or npos */
+  size_type locate(const key_type& key, size_type hash) const;
+
+  /** Claims a slot for a new element, reusing an erased one if possible */
+  size_type acquire();
+
+  /** Marks slot as occupied or free */
+  void occupy(size_type slot);
+  void vacate(size_type slot);
+
+  /** Destroys the element in slot, without finding the next element */
+  void erase_slot(size_type slot);
+
+  /** As erase_slot, given the position of slot in the look-up table */
+  void erase_slot(size_type slot, size_type position);
+
+  /** Inserts a (hash, slot) pair into the look-up table */
+  void link(size_type hash, size_type slot);
+
+  /** Removes the bucket at the given position, shifting back its successors */
+  void unlink(size_type position);
+
+  void rehash(size_type bucket_count);
+
+  std::vector<std::unique_ptr<slot_type[]>> chunks_;
+  std::vector<size_type> free_;  // erased slots available for reuse
+  std::vector<word_type> occupied_;  // a bit per slot, a word per chunk
+  std::vector<bucket> buckets_;
+  size_type slots_ = 0;          // slots handed out so far
+  size_type size_ = 0;
+  Hash hash_;
+  KeyEqual equal_;
+};
+
+template <typename K, typename T, typename H, typename E>
+template <bool Const>
+stable_hash_map<K, T, H, E>::basic_iterator<Const>::basic_iterator(
+    map_pointer map, size_type slot)
+    : map_(map), slot_(slot) {}
+
+template <typename K, typename T, typename H, typename E>
+template <bool Const>
+template <bool C, typename>
+stable_hash_map<K, T, H, E>::basic_iterator<Const>::basic_iterator(
+    const basic_iterator<false>& other)
+    : map_(other.map_), slot_(other.slot_) {}
+
+template <typename K, typename T, typename H, typename E>
+template <bool Const>
+typename stable_hash_map<K, T, H, E>::template basic_iterator<
+    Const>::reference
+    stable_hash_map<K, T, H, E>::basic_iterator<Const>::operator*() const {
+  return *map_->at(slot_);
+}
+
+template <typename K, typename T, typename H, typename E>
+template <bool Const>
+typename stable_hash_map<K, T, H, E>::template basic_iterator<Const>::pointer
+    stable_hash_map<K, T, H, E>::basic_iterator<Const>::operator->() const {
+  return &*map_->at(slot_);
+}
+
+template <typename K, typename T, typename H, typename E>
+template <bool Const>
+typename stable_hash_map<K, T, H, E>::template basic_iterator<Const>&
+stable_hash_map<K, T, H, E>::basic_iterator<Const>::operator++() {
+  slot_ = map_->next_occupied(slot_ + 1);
+  return *this;
+}
+
+template <typename K, typename T, typename H, typename E>
+template <bool Const>
+typename stable_hash_map<K, T, H, E>::template basic_iterator<Const>
+stable_hash_map<K, T, H, E>::basic_iterator<Const>::operator++(int dummy) {
+  (void)dummy;
+  auto copy = *this;
+  ++*this;
+  return copy;
+}
+
+template <typename K, typename T, typename H, typename E>
+template <bool Const>
+typename stable_hash_map<K, T, H, E>::size_type
+stable_hash_map<K, T, H, E>::basic_iterator<Const>::slot() const {
+  return slot_;
+}
+
+template <typename K, typename T, typename H, typename E>
+stable_hash_map<K, T, H, E>::stable_hash_map() : stable_hash_map(0) {}
+
+template <typename K, typename T, typename H, typename E>
+stable_hash_map<K, T, H, E>::stable_hash_map(size_type bucket_count,
+                                             const H& hash, const E& equal)
+    : hash_(hash), equal_(equal) {
+  reserve(bucket_count);
+}
+
+template <typename K, typename T, typename H, typename E>
+stable_hash_map<K, T, H, E>::stable_hash_map(
+    std::initializer_list<value_type> values)
+    : stable_hash_map(values.size()) {
+  for (const auto& value : values) {
+    insert(value);
+  }
+}
+
+template <typename K, typename T, typename H, typename E>
+stable_hash_map<K, T, H, E>::stable_hash_map(const stable_hash_map& other)
+    : stable_hash_map(other.size_, other.hash_, other.equal_) {
+  for (const auto& value : other) {
+    insert(value);
+  }
+}
+
+template <typename K, typename T, typename H, typename E>
+stable_hash_map<K, T, H, E>::stable_hash_map(stable_hash_map&& other) noexcept
+    : chunks_(std::move(other.chunks_)),
+      free_(std::move(other.free_)),
+      occupied_(std::move(other.occupied_)),
+      buckets_(std::move(other.buckets_)),
+      slots_(std::exchange(other.slots_, 0)),
+      size_(std::exchange(other.size_, 0)),
+      hash_(std::move(other.hash_)),
+      equal_(std::move(other.equal_)) {
+  other.clear();
+}
+
+template <typename K, typename T, typename H, typename E>
+stable_hash_map<K, T, H, E>& stable_hash_map<K, T, H, E>::operator=(
+    stable_hash_map&& other) noexcept {
+  if (this != &other) {
+    chunks_ = std::move(other.chunks_);
+    free_ = std::move(other.free_);
+    occupied_ = std::move(other.occupied_);
+    buckets_ = std::move(other.buckets_);
+    slots_ = std::exchange(other.slots_, 0);
+    size_ = std::exchange(other.size_, 0);
+    hash_ = std::move(other.hash_);
+    equal_ = std::move(other.equal_);
+    other.clear();
+  }
+  return *this;
+}
+
+template <typename K, typename T, typename H, typename E>
+stable_hash_map<K, T, H, E>& stable_hash_map<K, T, H, E>::operator=(
+    const stable_hash_map& other) {
+  if (this != &other) {
+    auto copy = stable_hash_map(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+template <typename K, typename T, typename H, typename E>
+stable_hash_map<K, T, H, E>::~stable_hash_map() = default;
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::iterator
+stable_hash_map<K, T, H, E>::begin() {
+  return iterator(this, next_occupied(0));
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::iterator
+stable_hash_map<K, T, H, E>::end() {
+  return iterator(this, npos);
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::const_iterator
+stable_hash_map<K, T, H, E>::begin() const {
+  return const_iterator(this, next_occupied(0));
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::const_iterator
+stable_hash_map<K, T, H, E>::end() const {
+  return const_iterator(this, npos);
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::const_iterator
+stable_hash_map<K, T, H, E>::cbegin() const {
+  return begin();
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::const_iterator
+stable_hash_map<K, T, H, E>::cend() const {
+  return end();
+}
+
+template <typename K, typename T, typename H, typename E>
+bool stable_hash_map<K, T, H, E>::empty() const {
+  return size_ == 0;
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::size_type
+stable_hash_map<K, T, H, E>::size() const {
+  return size_;
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::size_type
+stable_hash_map<K, T, H, E>::bucket_count() const {
+  return buckets_.size();
+}
+
+template <typename K, typename T, typename H, typename E>
+float stable_hash_map<K, T, H, E>::load_factor() const {
+  return buckets_.empty() ? 0.0f
+                          : static_cast<float>(size_) /
+                                static_cast<float>(buckets_.size());
+}
+
+template <typename K, typename T, typename H, typename E>
+void stable_hash_map<K, T, H, E>::reserve(size_type n) {
+  auto required = n + n / 3;  // keep the load factor at or below 0.75
+  if (required > buckets_.size()) {
+    auto count = size_type(8);
+    while (count < required) {
+      count *= 2;
+    }
+    rehash(count);
+  }
+}
+
+template <typename K, typename T, typename H, typename E>
+void stable_hash_map<K, T, H, E>::clear() {
+  chunks_.clear();
+  free_.clear();
+  occupied_.clear();
+  buckets_.assign(buckets_.size(), bucket());
+  slots_ = 0;
+  size_ = 0;
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::iterator
+stable_hash_map<K, T, H, E>::find(const key_type& key) {
+  auto position = locate(key, hash_(key));
+  return iterator(this, position == npos ? npos : buckets_[position].slot);
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::const_iterator
+stable_hash_map<K, T, H, E>::find(const key_type& key) const {
+  auto position = locate(key, hash_(key));
+  return const_iterator(this,
+                        position == npos ? npos : buckets_[position].slot);
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::size_type
+stable_hash_map<K, T, H, E>::count(const key_type& key) const {
+  return locate(key, hash_(key)) == npos ? 0 : 1;
+}
+
+template <typename K, typename T, typename H, typename E>
+void stable_hash_map<K, T, H, E>::prefetch(const key_type& key) const {
+  if (!buckets_.empty()) {
+    prefetch_memory(&buckets_[hash_(key) & (buckets_.size() - 1)]);
+  }
+}
+
+template <typename K, typename T, typename H, typename E>
+template <typename ForwardIt, typename OutputIt>
+OutputIt stable_hash_map<K, T, H, E>::find_many(ForwardIt first,
+                                                 ForwardIt last,
+                                                 OutputIt out) const {
+  size_type hashes[batch_size];
+  auto mask = buckets_.empty() ? 0 : buckets_.size() - 1;
+  while (first != last) {
+    auto batch = first;
+    size_type n = 0;
+    for (; first != last && n < batch_size; ++first, ++n) {
+      hashes[n] = hash_(*first);
+      if (!buckets_.empty()) {
+        prefetch_memory(&buckets_[hashes[n] & mask]);
+      }
+    }
+    for (size_type i = 0; i < n && !buckets_.empty(); ++i) {
+      // the element in the home bucket is usually the one compared
+      const auto& home = buckets_[hashes[i] & mask];
+      if (home.slot != npos) {
+        prefetch_memory(&at(home.slot));
+      }
+    }
+    for (size_type i = 0; i < n; ++i, ++batch) {
+      auto position = locate(*batch, hashes[i]);
+      *out++ = const_iterator(
+          this, position == npos ? npos : buckets_[position].slot);
+    }
+  }
+  return out;
+}
+
+template <typename K, typename T, typename H, typename E>
+template <typename... Args>
+std::pair<typename stable_hash_map<K, T, H, E>::iterator, bool>
+stable_hash_map<K, T, H, E>::emplace(Args&&... args) {
+  auto slot = acquire();
+  auto& value = at(slot).emplace(std::forward<Args>(args)...);
+  auto hash = hash_(value.first);
+  auto position = locate(value.first, hash);
+  if (position != npos) {  // already present, so give the slot back
+    at(slot).reset();
+    free_.push_back(slot);
+    return std::make_pair(iterator(this, buckets_[position].slot), false);
+  }
+  link(hash, slot);
+  occupy(slot);
+  ++size_;
+  return std::make_pair(iterator(this, slot), true);
+}
+
+template <typename K, typename T, typename H, typename E>
+template <typename... Args>
+typename stable_hash_map<K, T, H, E>::iterator
+stable_hash_map<K, T, H, E>::emplace_hint(const_iterator hint,
+                                          Args&&... args) {
+  (void)hint;
+  return emplace(std::forward<Args>(args)...).first;
+}
+
+template <typename K, typename T, typename H, typename E>
+std::pair<typename stable_hash_map<K, T, H, E>::iterator, bool>
+stable_hash_map<K, T, H, E>::insert(const value_type& value) {
+  return try_emplace(value.first, value.second);
+}
+
+template <typename K, typename T, typename H, typename E>
+template <typename... Args>
+std::pair<typename stable_hash_map<K, T, H, E>::iterator, bool>
+stable_hash_map<K, T, H, E>::try_emplace(const key_type& key,
+                                         Args&&... args) {
+  auto hash = hash_(key);
+  auto position = locate(key, hash);
+  if (position != npos) {
+    return std::make_pair(iterator(this, buckets_[position].slot), false);
+  }
+  auto slot = acquire();
+  at(slot).emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+  link(hash, slot);
+  occupy(slot);
+  ++size_;
+  return std::make_pair(iterator(this, slot), true);
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::mapped_type&
+stable_hash_map<K, T, H, E>::operator[](const key_type& key) {
+  return try_emplace(key).first->second;
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::iterator
+stable_hash_map<K, T, H, E>::erase(const_iterator pos) {
+  auto slot = pos.slot();
+  erase_slot(slot);
+  return iterator(this, next_occupied(slot + 1));
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::size_type
+stable_hash_map<K, T, H, E>::erase(const key_type& key) {
+  auto position = locate(key, hash_(key));
+  if (position == npos) {
+    return 0;
+  }
+  erase_slot(buckets_[position].slot, position);
+  return 1;
+}
+
+template <typename K, typename T, typename H, typename E>
+void stable_hash_map<K, T, H, E>::quick_erase(const_iterator pos) {
+  erase_slot(pos.slot());
+}
+
+template <typename K, typename T, typename H, typename E>
+bool stable_hash_map<K, T, H, E>::operator==(
+    const stable_hash_map& rhs) const {
+  if (size_ != rhs.size_) {
+    return false;
+  }
+  for (const auto& value : *this) {
+    auto it = rhs.find(value.first);
+    if (it == rhs.end() || !(it->second == value.second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename K, typename T, typename H, typename E>
+bool stable_hash_map<K, T, H, E>::operator!=(
+    const stable_hash_map& rhs) const {
+  return !(*this == rhs);
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::slot_type&
+stable_hash_map<K, T, H, E>::at(size_type slot) {
+  return chunks_[slot / chunk_size][slot % chunk_size];
+}
+
+template <typename K, typename T, typename H, typename E>
+const typename stable_hash_map<K, T, H, E>::slot_type&
+stable_hash_map<K, T, H, E>::at(size_type slot) const {
+  return chunks_[slot / chunk_size][slot % chunk_size];
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::size_type
+stable_hash_map<K, T, H, E>::next_occupied(size_type slot) const {
+  if (slot >= slots_) {
+    return npos;
+  }
+  auto index = slot / chunk_size;
+  auto word = occupied_[index] & (~word_type(0) << (slot % chunk_size));
+  while (word == 0) {
+    if (++index == occupied_.size()) {
+      return npos;
+    }
+    word = occupied_[index];
+  }
+  return index * chunk_size + lowest_bit(word);
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::size_type
+stable_hash_map<K, T, H, E>::lowest_bit(word_type word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<size_type>(__builtin_ctzll(word));
+#else
+  size_type result = 0;
+  for (; (word & 1) == 0; word >>= 1) {
+    ++result;
+  }
+  return result;
+#endif
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::size_type
+stable_hash_map<K, T, H, E>::locate(const key_type& key,
+                                    size_type hash) const {
+  if (buckets_.empty()) {
+    return npos;
+  }
+  auto mask = buckets_.size() - 1;
+  for (auto position = hash & mask;; position = (position + 1) & mask) {
+    const auto& entry = buckets_[position];
+    if (entry.slot == npos) {
+      return npos;
+    }
+    if (entry.hash == hash && equal_(at(entry.slot)->first, key)) {
+      return position;
+    }
+  }
+}
+
+template <typename K, typename T, typename H, typename E>
+typename stable_hash_map<K, T, H, E>::size_type
+stable_hash_map<K, T, H, E>::acquire() {
+  reserve(size_ + 1);
+  if (!free_.empty()) {
+    auto slot = free_.back();
+    free_.pop_back();
+    return slot;
+  }
+  if (slots_ == chunks_.size() * chunk_size) {
+    chunks_.push_back(std::make_unique<slot_type[]>(chunk_size));
+    occupied_.push_back(0);
+  }
+  return slots_++;
+}
+
+template <typename K, typename T, typename H, typename E>
+void stable_hash_map<K, T, H, E>::occupy(size_type slot) {
+  occupied_[slot / chunk_size] |= word_type(1) << (slot % chunk_size);
+}
+
+template <typename K, typename T, typename H, typename E>
+void stable_hash_map<K, T, H, E>::vacate(size_type slot) {
+  occupied_[slot / chunk_size] &= ~(word_type(1) << (slot % chunk_size));
+}
+
+template <typename K, typename T, typename H, typename E>
+void stable_hash_map<K, T, H, E>::erase_slot(size_type slot) {
+  const auto& key = at(slot)->first;
+  erase_slot(slot, locate(key, hash_(key)));
+}
+
+template <typename K, typename T, typename H, typename E>
+void stable_hash_map<K, T, H, E>::erase_slot(size_type slot,
+                                             size_type position) {
+  unlink(position);
+  vacate(slot);
+  at(slot).reset();
+  free_.push_back(slot);
+  --size_;
+}
+
+template <typename K, typename T, typename H, typename E>
+void stable_hash_map<K, T, H, E>::link(size_type hash, size_type slot) {
+  auto mask = buckets_.size() - 1;
+  auto position = hash & mask;
+  while (buckets_[position].slot != npos) {
+    position = (position + 1) & mask;
+  }
+  buckets_[position] = bucket{hash, slot};
+}
+
+template <typename K, typename T, typename H, typename E>
+void stable_hash_map<K, T, H, E>::unlink(size_type position) {
+  auto mask = buckets_.size() - 1;
+  auto next = position;
+  while (true) {  // move back any successor whose probe sequence spans the gap
+    next = (next + 1) & mask;
+    if (buckets_[next].slot == npos) {
+      break;
+    }
+    auto home = buckets_[next].hash & mask;
+    auto reachable = position <= next ? position < home && home <= next
+                                      : position < home || home <= next;
+    if (!reachable) {
+      buckets_[position] = buckets_[next];
+      position = next;
+    }
+  }
+  buckets_[position] = bucket();
+}
+
+template <typename K, typename T, typename H, typename E>
+void stable_hash_map<K, T, H, E>::rehash(size_type bucket_count) {
+  auto old = std::exchange(buckets_, std::vector<bucket>(bucket_count));
+  for (const auto& entry : old) {
+    if (entry.slot != npos) {
+      link(entry.hash, entry.slot);
+    }
+  }
+}
+
+}  // namespace vertex
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <vertex/async_traversal.h>
+#include <vertex/pod_node.h>
+#include <algorithm>
+#include <future>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+
+namespace {
+
+using TestNode = vertex::pod_node<std::string, std::string>;
+using Container = std::map<std::string, TestNode>;
+using LinkArray = typename TestNode::container_type;
+
+/** A store whose lookups run only once they are waited on, counting them
+ * and how many are outstanding at once */
+class deferred_store {
+ public:
+  using key_type = Container::key_type;
+  using mapped_type = Container::mapped_type;
+
+  explicit deferred_store(const Container& vertices) : vertices_(&vertices) {}
+
+  std::future<std::optional<mapped_type>> fetch(const key_type& key) const {
+    ++fetches_;
+    max_outstanding_ = std::max(max_outstanding_, ++outstanding_);
+    return std::async(std::launch::deferred, [this, key]() {
+      --outstanding_;
+      auto it = vertices_->find(key);
+      return it == vertices_->end() ? std::nullopt
+                                    : std::make_optional(it->second);
+    });
+  }
+
+  std::size_t fetches() const { return fetches_; }
+
+  std::size_t max_outstanding() const { return max_outstanding_; }
+
+ private:
+  const Container* vertices_;
+  mutable std::size_t fetches_ = 0;
+  mutable std::size_t outstanding_ = 0;
+  mutable std::size_t max_outstanding_ = 0;
+};
+
+}  // namespace
+
+namespace vertex {
+
+struct async_tree : public ::testing::Test {
+  Container vertices;
+
+  /*******************\
+   *         F        *
+   *        / \       *
+   *       /   \      *
+   *      B     G     *
+   *     / \     \    *
+   *    A   D     I   *
+   *       / \   /    *
+   *      C   E H     *
+  \*******************/
+
+  async_tree() {
+    vertices.emplace("A", TestNode("A"));
+    vertices.emplace("B", TestNode("B", LinkArray{"A", "D"}));
+    vertices.emplace("C", TestNode("C"));
+    vertices.emplace("D", TestNode("D", LinkArray{"C", "E"}));
+    vertices.emplace("E", TestNode("E"));
+    vertices.emplace("F", TestNode("F", LinkArray{"B", "G"}));
+    vertices.emplace("G", TestNode("G", LinkArray{"", "I"}));
+    vertices.emplace("H", TestNode("H"));
+    vertices.emplace("I", TestNode("I", LinkArray{"H", ""}));
+  }
+};
+
+template <typename Traverse>
+std::string order(Traverse traverse) {
+  auto output = std::ostringstream();
+  traverse([&output](const auto& key, const auto& vertex, std::size_t depth) {
+    EXPECT_EQ(key, *vertex);
+    output << key << depth;
+  });
+  return output.str();
+}
+
+TEST_F(async_tree, Traversals) {
+  auto store = container_store<Container>(vertices);
+  EXPECT_EQ("F0B1A2D2C3E3G1I2H3", order([&](auto visit) {
+              EXPECT_EQ(9u, async_pre_order(store, "F", visit));
+            }));
+  EXPECT_EQ("A2C3E3D2B1H3I2G1F0", order([&](auto visit) {
+              EXPECT_EQ(9u, async_post_order(store, "F", visit));
+            }));
+  EXPECT_EQ("F0B1G1A2D2I2C3E3H3", order([&](auto visit) {
+              EXPECT_EQ(9u, async_breadth_first(store, "F", visit));
+            }));
+  EXPECT_EQ("", order([&](auto visit) {
+              EXPECT_EQ(0u, async_pre_order(store, "X", visit));
+            }));
+}
+
+TEST_F(async_tree, LimitedTraversals) {
+  auto store = container_store<Container>(vertices);
+  auto options = async_traversal_options();
+  options.max_depth = 2;
+  EXPECT_EQ("F0B1A2D2G1I2", order([&](auto visit) {
+              async_pre_order(store, "F", visit, options);
+            }));
+  EXPECT_EQ("A2D2B1I2G1F0", order([&](auto visit) {
+              async_post_order(store, "F", visit, options);
+            }));
+  EXPECT_EQ("F0B1G1A2D2I2", order([&](auto visit) {
+              async_breadth_first(store, "F", visit, options);
+            }));
+
+  using Predicate = predicate_function<container_store<Container>>;
+  auto from_f = Predicate([](const auto& e) { return e.source() == "F"; });
+  EXPECT_EQ("F0B1G1", order([&](auto visit) {
+              async_breadth_first(store, "F", visit, {}, from_f);
+            }));
+  EXPECT_EQ("F0B1G1", order([&](auto visit) {
+              async_pre_order(store, "F", visit, {}, from_f);
+            }));
+}
+
+TEST(vertex, AsyncTraversalWindow) {
+  auto vertices = Container();
+  auto links = LinkArray();
+  for (auto i = 0; i < 100; ++i) {
+    auto key = std::to_string(i);
+    vertices.emplace(key, TestNode(key));
+    links.push_back(key);
+  }
+  vertices.emplace("root", TestNode("root", links));
+  auto options = async_traversal_options();
+  options.window = 8;
+  auto visit = [](const auto&, const auto&, std::size_t) {};
+  {
+    auto store = deferred_store(vertices);
+    EXPECT_EQ(101u, async_pre_order(store, "root", visit, options));
+    EXPECT_EQ(options.window, store.max_outstanding());
+  }
+  {
+    auto store = deferred_store(vertices);
+    EXPECT_EQ(101u, async_post_order(store, "root", visit, options));
+    EXPECT_EQ(options.window, store.max_outstanding());
+  }
+  {
+    auto store = deferred_store(vertices);
+    EXPECT_EQ(101u, async_breadth_first(store, "root", visit, options));
+    EXPECT_EQ(options.window, store.max_outstanding());
+  }
+}
+
+TEST(vertex, AsyncTraversalPrunedFetches) {
+  auto vertices = Container();
+  auto links = LinkArray();
+  for (auto i = 0; i < 100; ++i) {
+    auto key = std::to_string(i);
+    vertices.emplace(key, TestNode(key));
+    links.push_back(key);
+  }
+  vertices.emplace("root", TestNode("root", links));
+  using Predicate = predicate_function<deferred_store>;
+  auto even = Predicate([](const auto& e) {
+    return std::stoi(e.target()) % 2 == 0;
+  });
+  auto options = async_traversal_options();
+  options.window = 8;
+  auto visit = [](const auto&, const auto&, std::size_t) {};
+  {  // a rejected child is never fetched
+    auto store = deferred_store(vertices);
+    EXPECT_EQ(51u, async_pre_order(store, "root", visit, options, even));
+    EXPECT_EQ(51u, store.fetches());
+  }
+  {
+    auto store = deferred_store(vertices);
+    EXPECT_EQ(51u, async_post_order(store, "root", visit, options, even));
+    EXPECT_EQ(51u, store.fetches());
+  }
+  {
+    auto store = deferred_store(vertices);
+    EXPECT_EQ(51u, async_breadth_first(store, "root", visit, options, even));
+    EXPECT_EQ(51u, store.fetches());
+  }
+}
+
+}  // namespace vertex
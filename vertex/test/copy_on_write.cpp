@@ -0,0 +1,27 @@
+#include <gtest/gtest.h>
+#include <vertex/copy_on_write.h>
+#include <vector>
+
+namespace test {
+
+TEST(vertex, CopyOnWrite) {
+  auto empty = vertex::copy_on_write<std::vector<int>>();
+  EXPECT_FALSE(empty);
+  empty.mutate().push_back(1);  // created on first write
+  EXPECT_EQ(std::vector<int>{1}, empty.get());
+
+  auto original = vertex::copy_on_write<std::vector<int>>({1, 2, 3});
+  auto copy = original;
+  EXPECT_EQ(&original.get(), &copy.get());  // shared until written
+  copy.mutate().push_back(4);
+  EXPECT_NE(&original.get(), &copy.get());
+  EXPECT_EQ(std::size_t(3), original.get().size());
+  EXPECT_EQ(std::size_t(4), copy.get().size());
+  auto* unshared = &copy.mutate();
+  EXPECT_EQ(unshared, &copy.mutate());  // no further copies once unshared
+
+  struct stateless {};
+  static_assert(sizeof(vertex::copy_on_write<stateless>) == sizeof(stateless));
+}
+
+}  // namespace test
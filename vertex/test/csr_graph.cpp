@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <vertex/csr_graph.h>
+#include <vertex/csr_traversal.h>
+#include <vertex/pod_node.h>
+#include <vertex/pre_order_traversal.h>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace {
+
+using TestNode = vertex::pod_node<std::string, std::string>;
+using Container = std::map<std::string, TestNode>;
+using LinkArray = typename TestNode::container_type;
+using Graph = vertex::csr_graph<Container>;
+
+template <typename Traversal>
+std::string order(Traversal traversal) {
+  auto output = std::ostringstream();
+  for (const auto& v : traversal) {
+    output << *v.second;
+  }
+  return output.str();
+}
+
+template <typename Traversal>
+std::string depths(Traversal traversal) {
+  auto output = std::ostringstream();
+  for (auto it = traversal.begin(), end = traversal.end(); it != end; ++it) {
+    output << *it->second << it.depth();
+  }
+  return output.str();
+}
+
+}  // namespace
+
+namespace vertex {
+
+struct csr_tree : public ::testing::Test {
+  Container vertices;
+
+  /*******************\
+   *         F        *
+   *        / \       *
+   *       /   \      *
+   *      B     G     *
+   *     / \     \    *
+   *    A   D     I   *
+   *       / \   /    *
+   *      C   E H     *
+  \*******************/
+  csr_tree() {
+    vertices.insert(std::make_pair("A", TestNode("A")));
+    vertices.insert(std::make_pair("C", TestNode("C")));
+    vertices.insert(std::make_pair("E", TestNode("E")));
+    vertices.insert(std::make_pair("H", TestNode("H")));
+    vertices.insert(std::make_pair("D", TestNode("D", LinkArray{"C", "E"})));
+    vertices.insert(std::make_pair("B", TestNode("B", LinkArray{"A", "D"})));
+    vertices.insert(std::make_pair("F", TestNode("F", LinkArray{"B", "G"})));
+    vertices.insert(std::make_pair("G", TestNode("G", LinkArray{"", "I"})));
+    vertices.insert(std::make_pair("I", TestNode("I", LinkArray{"H", ""})));
+  }
+};
+
+TEST_F(csr_tree, Freeze) {
+  auto graph = Graph(vertices);
+  EXPECT_EQ(vertices.size(), graph.size());
+  EXPECT_EQ(std::size_t(10), graph.edge_count());
+  EXPECT_EQ(Graph::npos, graph.index("Z"));
+  auto f = graph.index("F");
+  ASSERT_NE(Graph::npos, f);
+  EXPECT_EQ("F", graph.key(f));
+  auto children = graph.children(f);
+  ASSERT_EQ(std::size_t(2), children.size());
+  EXPECT_EQ("B", graph.key(children[0]));
+  EXPECT_EQ("G", graph.key(children[1]));
+  auto g = graph.children(graph.index("G"));
+  EXPECT_EQ(Graph::npos, g[0]);  // unresolved links keep their position
+
+  // the snapshot matches the map based traversal
+  EXPECT_EQ(order(pre_order_traversal<Container>(vertices, vertices.find("F"))),
+            order(csr_pre_order_traversal<Container>(graph, f)));
+}
+
+TEST_F(csr_tree, Traversals) {
+  auto graph = Graph(vertices);
+  auto f = graph.index("F");
+  EXPECT_EQ("FBADCEGIH", order(csr_pre_order_traversal<Container>(graph, f)));
+  EXPECT_EQ("ACEDBHIGF", order(csr_post_order_traversal<Container>(graph, f)));
+  EXPECT_EQ("ABCDEFGHI", order(csr_in_order_traversal<Container>(graph, f)));
+  EXPECT_EQ("FBGADICEH",
+            order(csr_breadth_first_traversal<Container>(graph, f)));
+  auto b = graph.index("B");
+  EXPECT_EQ("ABCDE", order(csr_in_order_traversal<Container>(graph, b)));
+
+  using All = unconditional<Container>;
+  EXPECT_EQ("FBADCEGIH",
+            order(csr_pre_order_traversal<Container, All>(graph, f)));
+  EXPECT_EQ("FBGADICEH",
+            order(csr_breadth_first_traversal<Container, All>(graph, f)));
+
+  auto empty = csr_pre_order_traversal<Container>(graph, Graph::npos);
+  EXPECT_EQ(empty.end(), empty);
+}
+
+TEST_F(csr_tree, PredicatedTraversals) {
+  auto graph = Graph(vertices);
+  auto f = graph.index("F");
+  auto in_order = csr_in_order_traversal<Container>(
+      graph, f, [](const auto& e) -> bool {
+        return e.target() == "G" || e.target() == "F" || e.target() == "I";
+      });
+  EXPECT_EQ("FGI", order(in_order));
+  auto bfs = csr_breadth_first_traversal<Container>(
+      graph, f, [](const auto& e) -> bool { return e.source() == "F"; });
+  EXPECT_EQ("FBG", order(bfs));
+}
+
+TEST_F(csr_tree, MaxDepthTraversals) {
+  auto graph = Graph(vertices);
+  auto f = graph.index("F");
+  using All = unconditional<Container>;
+  EXPECT_EQ("F0B1A2D2C3E3G1I2H3",
+            depths(csr_pre_order_traversal<Container, All>(graph, f)));
+  EXPECT_EQ("F0B1A2D2G1I2",
+            depths(csr_pre_order_traversal<Container, All>(graph, f, {}, 2)));
+  EXPECT_EQ("A2D2B1I2G1F0",
+            depths(csr_post_order_traversal<Container, All>(graph, f, {}, 2)));
+  EXPECT_EQ("A2B1D2F0G1I2",
+            depths(csr_in_order_traversal<Container, All>(graph, f, {}, 2)));
+  EXPECT_EQ("F0B1G1A2D2I2", depths(csr_breadth_first_traversal<Container, All>(
+                                graph, f, {}, 2)));
+  EXPECT_EQ("F0", depths(csr_breadth_first_traversal<Container>(graph, f,
+                                                                 {}, 0)));
+}
+
+TEST(vertex, VisitedCsrTraversal) {
+  auto vertices = Container();
+  vertices.emplace("A", TestNode("A", LinkArray{"B", "C"}));
+  vertices.emplace("B", TestNode("B", LinkArray{"D", "E"}));
+  vertices.emplace("C", TestNode("C", LinkArray{"D", "E"}));
+  vertices.emplace("D", TestNode("D"));
+  vertices.emplace("E", TestNode("E", LinkArray{"A"}));  // a cycle
+  auto graph = Graph(vertices);
+  auto a = graph.index("A");
+  using All = unconditional<Container>;
+  using Visited = visited_bitmap;
+  EXPECT_EQ("ABDEC",
+            order(csr_pre_order_traversal<Container, All, Visited>(graph, a)));
+  EXPECT_EQ("DEBCA",
+            order(csr_post_order_traversal<Container, All, Visited>(graph, a)));
+  EXPECT_EQ("DBEAC",
+            order(csr_in_order_traversal<Container, All, Visited>(graph, a)));
+  EXPECT_EQ("ABCDE", order(csr_breadth_first_traversal<Container, All, Visited>(
+                         graph, a)));
+}
+
+}  // namespace vertex
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <vertex/fold.h>
+#include <vertex/pod_node.h>
+#include <atomic>
+#include <map>
+#include <string>
+
+namespace {
+
+using TestNode = vertex::pod_node<std::string, std::string>;
+using Container = std::map<std::string, TestNode>;
+using LinkArray = typename TestNode::container_type;
+
+/** Nests the keys of a subtree, as in "a(b(d)c)" */
+std::string nest(const std::string& acc, const std::string& child) {
+  return acc.back() == ')' ? acc.substr(0, acc.size() - 1) + child + ")"
+                           : acc + "(" + child + ")";
+}
+
+/** A ternary tree of n vertices, in which i links to 3i+1, 3i+2 and 3i+3 */
+Container ternary(std::size_t n) {
+  auto vertices = Container();
+  for (std::size_t i = 0; i < n; ++i) {
+    auto links = LinkArray();
+    for (auto child = 3 * i + 1; child < n && child <= 3 * i + 3; ++child) {
+      links.push_back(std::to_string(child));
+    }
+    auto key = std::to_string(i);
+    vertices.emplace(key, TestNode(key, links));
+  }
+  return vertices;
+}
+
+}  // namespace
+
+namespace vertex {
+
+TEST(vertex, Fold) {
+  /*******************\
+   *        a         *
+   *      / | \       *
+   *     b  c  e      *
+   *     |  |         *
+   *     d  d         *
+   *     |            *
+   *     a (cycle)    *
+  \*******************/
+  auto vertices = Container();
+  vertices.emplace("a", TestNode("a", LinkArray{"b", "c", "e", "x"}));
+  vertices.emplace("b", TestNode("b", LinkArray{"d"}));
+  vertices.emplace("c", TestNode("c", LinkArray{"d"}));
+  vertices.emplace("d", TestNode("d", LinkArray{"a"}));
+  vertices.emplace("e", TestNode("e"));
+
+  auto leaves = std::atomic<std::size_t>(0);
+  auto key = [&leaves](const auto& vertex) {
+    ++leaves;
+    return vertex.first;
+  };
+  auto root = vertices.find("a");
+  EXPECT_EQ("a(b(d)c(d)e)", fold(vertices, root, key, nest));
+  EXPECT_EQ(5u, leaves.load());  // d is computed once, and x is missing
+
+  auto one = [](const auto&) { return std::size_t(1); };
+  auto sum = [](std::size_t acc, std::size_t child) { return acc + child; };
+  EXPECT_EQ(6u, fold(vertices, root, one, sum));
+  // from b the cycle closes at b instead, as b(d(a(c e)))
+  EXPECT_EQ(5u, fold(vertices, vertices.find("b"), one, sum));
+  EXPECT_FALSE(fold(vertices, vertices.end(), one, sum).has_value());
+}
+
+TEST(vertex, ParallelFold) {
+  const auto n = std::size_t(3000);
+  auto vertices = ternary(n);
+  auto root = vertices.find("0");
+  auto one = [](const auto&) { return std::size_t(1); };
+  auto sum = [](std::size_t acc, std::size_t child) { return acc + child; };
+  auto key = [](const auto& vertex) { return vertex.first; };
+  auto sequential = fold(vertices, root, key, nest);
+  auto options = fold_options();
+  options.threads = 4;
+  options.grain = 8;
+  EXPECT_EQ(n, fold(vertices, root, one, sum, options));
+  EXPECT_EQ(sequential, fold(vertices, root, key, nest, options));
+}
+
+}  // namespace vertex
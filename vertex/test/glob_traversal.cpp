@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <vertex/glob_traversal.h>
+#include <vertex/pod_node.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace test {
+
+using TestNode = vertex::pod_node<std::string, std::string>;
+using Container = std::map<std::string, TestNode>;
+using LinkArray = typename TestNode::container_type;
+using Path = std::vector<std::string>;
+
+/** Lists the paths visited by a glob_traversal, joined by '/' */
+template <typename Traversal>
+std::vector<std::string> list(Traversal traversal) {
+  auto result = std::vector<std::string>();
+  for (auto it = traversal.begin(), end = traversal.end(); it != end; ++it) {
+    auto path = std::string();
+    for (const auto& segment : it.path()) {
+      path += "/" + segment;
+    }
+    result.push_back(path);
+  }
+  return result;
+}
+
+TEST(vertex, GlobPattern) {
+  auto pattern = vertex::glob_pattern("/home/*/documents/**.log");
+  EXPECT_TRUE(pattern.matches(Path{"home", "bob", "documents", "a.log"}));
+  EXPECT_TRUE(
+      pattern.matches(Path{"home", "bob", "documents", "x", "y", "b.log"}));
+  EXPECT_FALSE(pattern.matches(Path{"home", "bob", "documents", "a.txt"}));
+  EXPECT_FALSE(pattern.matches(Path{"home", "documents", "a.log"}));
+  EXPECT_FALSE(pattern.matches(Path{"home", "bob", "documents"}));
+
+  auto everything = vertex::glob_pattern("**");
+  EXPECT_TRUE(everything.matches(Path{}));
+  EXPECT_TRUE(everything.matches(Path{"a", "b"}));
+
+  auto classes = vertex::glob_pattern("log/[a-c]?[!0-9]*");
+  EXPECT_TRUE(classes.matches(Path{"log", "a1x"}));
+  EXPECT_TRUE(classes.matches(Path{"log", "c_zzz"}));
+  EXPECT_FALSE(classes.matches(Path{"log", "d1x"}));
+  EXPECT_FALSE(classes.matches(Path{"log", "a12"}));
+  EXPECT_FALSE(classes.matches(Path{"log", "a1"}));
+  EXPECT_TRUE(vertex::glob_pattern("[]x]").matches(Path{"]"}));
+  EXPECT_TRUE(vertex::glob_pattern("a[b").matches(Path{"a[b"}));
+
+  auto middle = vertex::glob_pattern("a/**/b");
+  EXPECT_TRUE(middle.matches(Path{"a", "b"}));
+  EXPECT_TRUE(middle.matches(Path{"a", "x", "y", "b"}));
+  EXPECT_FALSE(middle.matches(Path{"a", "x", "y"}));
+
+  auto states = std::vector<std::string_view>();
+  EXPECT_TRUE(pattern.literals(pattern.start(), states));
+  EXPECT_EQ(std::vector<std::string_view>{"home"}, states);
+  auto below = pattern.next(pattern.start(), "home");
+  EXPECT_FALSE(pattern.literals(below, states));
+  EXPECT_TRUE(pattern.next(pattern.start(), "var").empty());
+}
+
+TEST(vertex, GlobTraversal) {
+  auto vertices = Container{
+      std::make_pair("/", TestNode("", LinkArray{"home", "var"})),
+      std::make_pair("home", TestNode("", LinkArray{"bob", "jim"})),
+      std::make_pair("bob", TestNode("", LinkArray{"documents", "a.log"})),
+      std::make_pair("jim", TestNode("", LinkArray{"documents"})),
+      std::make_pair("documents", TestNode("", LinkArray{"b.log", "c.txt"})),
+      std::make_pair("a.log", TestNode("")),
+      std::make_pair("b.log", TestNode("")),
+      std::make_pair("c.txt", TestNode("")),
+      std::make_pair("var", TestNode("", LinkArray{"log"})),
+      std::make_pair("log", TestNode("", LinkArray{"a.log"}))};
+  auto root = vertices.find("/");
+  using Traversal = vertex::glob_traversal<Container>;
+  using Paths = std::vector<std::string>;
+  auto glob = [&](const char* pattern) {
+    return list(Traversal(vertices, root, vertex::glob_pattern(pattern)));
+  };
+  EXPECT_EQ((Paths{"", "/home/bob/documents/b.log",
+                   "/home/jim/documents/b.log"}),
+            glob("/home/*/documents/**.log"));
+  EXPECT_EQ((Paths{"", "/home/bob/documents/b.log", "/home/bob/a.log",
+                   "/home/jim/documents/b.log", "/var/log/a.log"}),
+            glob("**/*.log"));
+  EXPECT_EQ((Paths{"", "/home/bob", "/home/jim"}), glob("home/*"));
+  EXPECT_EQ((Paths{""}), glob("home/alice/*"));
+
+  // only the edges the pattern can follow are tested
+  auto tested = Paths();
+  auto predicate = [&](const vertex::edge<Container>& edge) {
+    tested.push_back(edge.source() + ">" + edge.target());
+    return true;
+  };
+  using Recording =
+      vertex::glob_traversal<Container, vertex::predicate_function<Container>>;
+  EXPECT_EQ((Paths{"", "/home/jim/documents"}),
+            list(Recording(vertices, root,
+                           vertex::glob_pattern("home/jim/documents"),
+                           predicate)));
+  EXPECT_EQ((Paths{"/>home", "home>jim", "jim>documents"}), tested);
+  tested.clear();
+  EXPECT_EQ((Paths{"", "/var/log"}),
+            list(Recording(vertices, root, vertex::glob_pattern("v*/log"),
+                           predicate)));
+  EXPECT_EQ((Paths{"/>var", "var>log"}), tested);
+
+  // the depth limit stops descent below max_depth
+  EXPECT_EQ((Paths{"", "/home/bob/a.log", "/var/log/a.log"}),
+            list(Traversal(vertices, root, vertex::glob_pattern("**.log"),
+                           vertex::unconditional<Container>(), 3)));
+}
+
+}  // namespace test
@@ -0,0 +1,286 @@
+#include <gtest/gtest.h>
+#include <vertex/ancestor_traversal.h>
+#include <vertex/counted_node.h>
+#include <vertex/managed_container.h>
+#include <vertex/pod_node.h>
+#include <vertex/stable_hash_map.h>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace test {
+
+using TestNode = vertex::pod_node<std::string, std::string>;
+using LinkArray = TestNode::container_type;
+using CountedNode = vertex::counted_node<TestNode>;
+
+template <typename Managed>
+void insert_dag(Managed& managed) {
+  /*******************\
+   *   a1    a2       *
+   *    \   /  \      *
+   *     \ /    \     *
+   *      b      c    *
+   *      |           *
+   *      d           *
+  \*******************/
+  managed.insert(std::make_pair("d", TestNode("d")));
+  managed.insert(std::make_pair("b", TestNode("b", LinkArray{"d"})));
+  managed.insert(std::make_pair("c", TestNode("c")));
+  managed.insert(std::make_pair("a1", TestNode("a1", LinkArray{"b"})));
+  managed.insert(std::make_pair("a2", TestNode("a2", LinkArray{"b", "c"})));
+}
+
+template <typename Managed>
+void bulk_insert_dag(Managed& managed) {
+  using value_type = typename Managed::value_type;
+  // parents precede their children, and a duplicate key is ignored
+  auto values = std::vector<value_type>{
+      {"a2", TestNode("a2", LinkArray{"b", "c"})},
+      {"a1", TestNode("a1", LinkArray{"b"})},
+      {"b", TestNode("b", LinkArray{"d"})},
+      {"b", TestNode("x", LinkArray{"c"})},
+      {"d", TestNode("d")}};
+  managed.insert(std::make_pair("c", TestNode("c")));
+  EXPECT_EQ(std::size_t(4), managed.insert(values.begin(), values.end()));
+  EXPECT_EQ("b", *managed.find("b")->second);
+}
+
+template <typename Managed>
+void erase_dag(Managed& managed) {
+  EXPECT_EQ(std::size_t(5), managed.size());
+  EXPECT_EQ(std::size_t(2), managed.count("b"));
+  EXPECT_EQ(std::size_t(1), managed.count("c"));
+  EXPECT_EQ(std::size_t(1), managed.count("d"));
+  EXPECT_EQ(std::size_t(0), managed.count("a1"));
+  EXPECT_FALSE(managed.insert(std::make_pair("c", TestNode("c"))).second);
+  EXPECT_EQ(std::size_t(1), managed.count("c"));  // duplicates add no edges
+
+  // a referenced vertex is not erased
+  managed.erase(managed.find("b"));
+  EXPECT_NE(managed.end(), managed.find("b"));
+
+  managed.erase(managed.find("a1"));
+  EXPECT_EQ(std::size_t(4), managed.size());
+  EXPECT_EQ(std::size_t(1), managed.count("b"));
+
+  // erasing the last root cascades through its unreferenced descendants
+  managed.erase(managed.find("a2"));
+  EXPECT_EQ(std::size_t(0), managed.size());
+  EXPECT_EQ(managed.begin(), managed.end());
+}
+
+TEST(vertex, ManagedContainer) {
+  using Container = std::map<std::string, TestNode>;
+  using EdgeMap = std::multimap<std::string, std::string>;
+  auto managed = vertex::managed_container<Container, EdgeMap>();
+  insert_dag(managed);
+  erase_dag(managed);
+}
+
+TEST(vertex, IntrusiveManagedContainer) {
+  using Container = std::map<std::string, CountedNode>;
+  auto managed = vertex::managed_container<Container>();
+  insert_dag(managed);
+  erase_dag(managed);
+
+  using HashMap = vertex::stable_hash_map<std::string, CountedNode>;
+  auto hashed = vertex::managed_container<HashMap>();
+  insert_dag(hashed);
+  erase_dag(hashed);
+}
+
+TEST(vertex, BulkInsertManagedContainer) {
+  using Container = std::map<std::string, TestNode>;
+  using EdgeMap = std::multimap<std::string, std::string>;
+  auto managed = vertex::managed_container<Container, EdgeMap>();
+  bulk_insert_dag(managed);
+  erase_dag(managed);
+
+  using HashMap = vertex::stable_hash_map<std::string, CountedNode>;
+  auto hashed = vertex::managed_container<HashMap>();
+  bulk_insert_dag(hashed);
+  erase_dag(hashed);
+}
+
+template <typename Managed>
+void collect_dag(Managed& managed) {
+  managed.reclamation(vertex::reclamation_mode::deferred);
+  managed.erase(managed.find("a1"));
+  EXPECT_EQ(std::size_t(5), managed.size());  // only marked dead
+  EXPECT_EQ(std::size_t(1), managed.garbage());
+  EXPECT_EQ(std::size_t(2), managed.count("b"));
+  EXPECT_EQ(std::size_t(1), managed.collect(1));
+  EXPECT_EQ(std::size_t(4), managed.size());
+  EXPECT_EQ(std::size_t(1), managed.count("b"));
+
+  managed.erase(managed.find("a2"));
+  EXPECT_EQ(std::size_t(1), managed.collect(1));  // a2, leaving b and c dead
+  EXPECT_EQ(std::size_t(2), managed.garbage());
+  EXPECT_EQ(std::size_t(3), managed.size());
+  EXPECT_EQ(std::size_t(3), managed.collect());
+  EXPECT_EQ(std::size_t(0), managed.garbage());
+  EXPECT_EQ(std::size_t(0), managed.size());
+
+  // re-inserting a dead vertex revives it
+  insert_dag(managed);
+  managed.erase(managed.find("a1"));
+  managed.insert(std::make_pair("a1", TestNode("a1", LinkArray{"b"})));
+  EXPECT_EQ(std::size_t(0), managed.collect());
+  EXPECT_EQ(std::size_t(5), managed.size());
+}
+
+TEST(vertex, DeferredManagedContainer) {
+  using Container = std::map<std::string, TestNode>;
+  using EdgeMap = std::multimap<std::string, std::string>;
+  auto managed = vertex::managed_container<Container, EdgeMap>();
+  insert_dag(managed);
+  collect_dag(managed);
+
+  using HashMap = vertex::stable_hash_map<std::string, CountedNode>;
+  auto hashed = vertex::managed_container<HashMap>();
+  insert_dag(hashed);
+  collect_dag(hashed);
+}
+
+template <typename Managed>
+void sweep_dag(Managed& managed) {
+  auto roots = std::vector<std::string>{"a2", "missing"};
+  EXPECT_EQ(std::size_t(1), managed.mark_and_sweep(roots.begin(), roots.end()));
+  EXPECT_EQ(std::size_t(4), managed.size());
+  EXPECT_EQ(managed.end(), managed.find("a1"));
+  EXPECT_EQ(std::size_t(1), managed.count("b"));  // a1's edge was released
+
+  // a wide graph, with unreachable vertices, spreads over several threads
+  managed.clear();
+  auto wide = LinkArray();
+  managed.insert(std::make_pair("leaf", TestNode("leaf")));
+  for (auto i = 0; i < 1000; ++i) {
+    auto key = "w" + std::to_string(i);
+    managed.insert(std::make_pair(key, TestNode(key, LinkArray{"leaf"})));
+    if (i % 4 != 0) {
+      wide.push_back(key);
+    }
+  }
+  managed.insert(std::make_pair("root", TestNode("root", wide)));
+  roots = {"root"};
+  EXPECT_EQ(std::size_t(250),
+            managed.mark_and_sweep(roots.begin(), roots.end(), 4));
+  EXPECT_EQ(std::size_t(752), managed.size());
+  EXPECT_EQ(std::size_t(750), managed.count("leaf"));
+  EXPECT_EQ(managed.end(), managed.find("w0"));
+  EXPECT_NE(managed.end(), managed.find("w1"));
+
+  roots.clear();
+  EXPECT_EQ(std::size_t(752),
+            managed.mark_and_sweep(roots.begin(), roots.end(), 4));
+  EXPECT_EQ(std::size_t(0), managed.size());
+}
+
+TEST(vertex, MarkAndSweepManagedContainer) {
+  using Container = std::map<std::string, TestNode>;
+  using EdgeMap = std::multimap<std::string, std::string>;
+  auto managed = vertex::managed_container<Container, EdgeMap>();
+  insert_dag(managed);
+  sweep_dag(managed);
+
+  using HashMap = vertex::stable_hash_map<std::string, CountedNode>;
+  auto hashed = vertex::managed_container<HashMap>();
+  insert_dag(hashed);
+  sweep_dag(hashed);
+}
+
+template <typename Managed>
+void repair_dag(Managed& managed) {
+  auto roots = std::vector<std::string>{"a1", "a2"};
+  EXPECT_EQ(std::size_t(0), managed.mark_and_sweep(roots.begin(), roots.end()));
+  EXPECT_EQ(std::size_t(2), managed.count("b"));
+  EXPECT_EQ(std::size_t(1), managed.count("c"));
+  EXPECT_EQ(std::size_t(1), managed.count("d"));
+  EXPECT_EQ(std::size_t(0), managed.count("a1"));
+  EXPECT_EQ(std::size_t(0), managed.garbage());
+
+  // erasure cascades by the rebuilt counts
+  managed.erase(managed.find("a1"));
+  EXPECT_EQ(std::size_t(4), managed.size());
+  EXPECT_NE(managed.end(), managed.find("d"));
+  managed.erase(managed.find("a2"));
+  EXPECT_EQ(std::size_t(0), managed.size());
+
+  // an erased root, still unreferenced, stays pending collection
+  insert_dag(managed);
+  managed.reclamation(vertex::reclamation_mode::deferred);
+  managed.erase(managed.find("a1"));
+  EXPECT_EQ(std::size_t(0), managed.mark_and_sweep(roots.begin(), roots.end()));
+  EXPECT_EQ(std::size_t(1), managed.garbage());
+  EXPECT_EQ(std::size_t(1), managed.collect());
+  EXPECT_EQ(std::size_t(1), managed.count("b"));
+}
+
+TEST(vertex, RebuildManagedContainer) {
+  using Container = std::map<std::string, TestNode>;
+  using EdgeMap = std::multimap<std::string, std::string>;
+  auto dag = vertex::managed_container<Container, EdgeMap>();
+  insert_dag(dag);
+  // restore the vertices alongside a corrupt index, as after a crash
+  auto corrupt = EdgeMap{{"b", "a1"}, {"b", "a1"}, {"b", "x"}, {"e", "b"}};
+  auto managed =
+      vertex::managed_container<Container, EdgeMap>(dag.vertices(), corrupt);
+  EXPECT_EQ(std::size_t(3), managed.count("b"));
+  EXPECT_EQ(std::size_t(0), managed.count("d"));
+  repair_dag(managed);
+
+  using HashMap = vertex::stable_hash_map<std::string, CountedNode>;
+  auto hashed = vertex::managed_container<HashMap>();
+  insert_dag(hashed);
+  hashed.find("b")->second.acquire();  // a count too high
+  hashed.find("d")->second.release();  // and one too low
+  repair_dag(hashed);
+}
+
+TEST(vertex, AncestorTraversal) {
+  using Container = std::map<std::string, TestNode>;
+  using EdgeMap = std::multimap<std::string, std::string>;
+  using All = vertex::unconditional<Container>;
+  using Ancestors = vertex::ancestor_traversal<Container, EdgeMap, All>;
+  auto managed = vertex::managed_container<Container, EdgeMap>();
+  insert_dag(managed);
+  auto walk = [&managed](const std::string& key, const EdgeMap& parents,
+                         std::size_t max_depth = Ancestors::unlimited) {
+    const auto& vertices = managed.vertices();
+    auto output = std::ostringstream();
+    auto traversal = Ancestors(vertices, parents, vertices.find(key), {},
+                               max_depth);
+    for (auto it = traversal.begin(); it != traversal.end(); ++it) {
+      output << it->first << (it.is_root() ? "* " : " ");
+    }
+    return output.str();
+  };
+  EXPECT_EQ("d b a1* a2* ", walk("d", managed.parents()));
+  EXPECT_EQ("c a2* ", walk("c", managed.parents()));
+  EXPECT_EQ("d b ", walk("d", managed.parents(), 1));
+  EXPECT_EQ(walk("d", managed.parents()),
+            walk("d", vertex::parent_index(managed.vertices())));
+
+  // the index follows erasure
+  managed.erase(managed.find("a1"));
+  EXPECT_EQ("d b a2* ", walk("d", managed.parents()));
+}
+
+TEST(vertex, CountedNode) {
+  auto node = CountedNode(TestNode("x", LinkArray{"y"}));
+  EXPECT_EQ(std::size_t(1), node.acquire());
+  EXPECT_EQ(std::size_t(2), node.acquire());
+  auto copy = node;  // the count belongs to the stored vertex
+  EXPECT_EQ(std::size_t(0), copy.references());
+  EXPECT_EQ(node, copy);
+  node = CountedNode(TestNode("z"));
+  EXPECT_EQ(std::size_t(2), node.references());
+  EXPECT_EQ("z", *node);
+  EXPECT_EQ(std::size_t(1), node.release());
+  node.reset(3);
+  EXPECT_EQ(std::size_t(3), node.references());
+}
+
+}  // namespace test
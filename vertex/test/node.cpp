@@ -60,4 +60,35 @@ TEST(vertex, Node) {
   }
 }
 
+TEST(vertex, OrderedNode) {
+  using OrderedNode = vertex::pod_node<TestLink, std::string,
+                                      std::vector<TestLink>,
+                                      vertex::ordered_links>;
+  auto node = OrderedNode("sorted", {TestLink(5), TestLink(1), TestLink(5)});
+  EXPECT_EQ(std::size_t(2), node.size());
+  EXPECT_TRUE(std::is_sorted(node.begin(), node.end()));
+
+  auto inserted = node.insert(TestLink(3));
+  EXPECT_TRUE(inserted.second);
+  EXPECT_EQ(TestLink(3), *inserted.first);
+  EXPECT_FALSE(node.insert(TestLink(3)).second);
+  EXPECT_NE(node.end(), node.find(TestLink(3)));
+  EXPECT_EQ(node.end(), node.find(TestLink(4)));
+  EXPECT_EQ(std::size_t(1), node.count(TestLink(5)));
+  EXPECT_EQ(std::size_t(0), node.count(TestLink(4)));
+
+  std::vector<TestLink> children{TestLink(9), TestLink(0), TestLink(3),
+                                 TestLink(7), TestLink(0)};
+  node.insert(children.begin(), children.end());
+  auto expected = std::vector<TestLink>{TestLink(0), TestLink(1), TestLink(3),
+                                        TestLink(5), TestLink(7), TestLink(9)};
+  EXPECT_TRUE(
+      std::equal(node.begin(), node.end(), expected.begin(), expected.end()));
+
+  EXPECT_EQ(std::size_t(1), node.erase(TestLink(5)));
+  EXPECT_EQ(std::size_t(0), node.erase(TestLink(5)));
+  EXPECT_EQ(node.end(), node.find(TestLink(5)));
+  EXPECT_EQ(std::size_t(5), node.size());
+}
+
 }  // namespace test
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <vertex/csr_graph.h>
+#include <vertex/parallel_breadth_first.h>
+#include <vertex/pod_node.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+using TestNode = vertex::pod_node<std::string, std::size_t>;
+using Container = std::map<std::string, TestNode>;
+using LinkArray = typename TestNode::container_type;
+using Graph = vertex::csr_graph<Container>;
+
+/** A complete binary heap of n vertices, in which i links to 2i+1 and 2i+2,
+ * plus a shortcut from every vertex to the last one */
+Container heap(std::size_t n) {
+  auto vertices = Container();
+  for (std::size_t i = 0; i < n; ++i) {
+    auto links = LinkArray();
+    for (auto child : {2 * i + 1, 2 * i + 2, n - 1}) {
+      if (child < n && child != i) {
+        links.push_back(std::to_string(child));
+      }
+    }
+    vertices.emplace(std::to_string(i), TestNode(i, links));
+  }
+  return vertices;
+}
+
+std::size_t depth(std::size_t i) {
+  auto result = std::size_t(0);
+  for (++i; i > 1; i /= 2) {
+    ++result;
+  }
+  return result;
+}
+
+}  // namespace
+
+namespace vertex {
+
+TEST(vertex, ParallelBreadthFirst) {
+  const auto n = std::size_t(5000);
+  auto vertices = heap(n);
+  auto graph = Graph(vertices);
+  for (auto direction_optimizing : {false, true}) {
+    auto options = parallel_bfs_options();
+    options.threads = 4;
+    options.grain = 16;
+    options.direction_optimizing = direction_optimizing;
+    auto depths = std::vector<std::size_t>(n, n);
+    auto reached = parallel_breadth_first(
+        graph, graph.index("0"),
+        [&](std::size_t level, const std::vector<std::size_t>& batch) {
+          for (auto index : batch) {
+            EXPECT_EQ(n, depths[*graph[index].second]);  // visited once
+            depths[*graph[index].second] = level;
+          }
+        },
+        options);
+    EXPECT_EQ(n, reached);
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+      ASSERT_EQ(depth(i), depths[i]) << i;
+    }
+    EXPECT_EQ(std::size_t(1), depths[n - 1]);  // via the shortcut
+  }
+}
+
+TEST(vertex, PredicatedParallelBreadthFirst) {
+  auto vertices = heap(1000);
+  auto graph = Graph(vertices);
+  auto levels = std::size_t(0);
+  auto reached = parallel_breadth_first(
+      graph, graph.index("0"),
+      [&levels](std::size_t, const std::vector<std::size_t>&) { ++levels; },
+      parallel_bfs_options(), [](const edge<Container>& e) {
+        return std::stoul(e.target()) < 100;  // skips the shortcut
+      });
+  EXPECT_EQ(std::size_t(100), reached);
+  EXPECT_EQ(std::size_t(7), levels);
+
+  reached = parallel_breadth_first(
+      graph, Graph::npos, [](std::size_t, const std::vector<std::size_t>&) {});
+  EXPECT_EQ(std::size_t(0), reached);
+}
+
+}  // namespace vertex
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <vertex/atomic_bitmap.h>
+#include <vertex/parallel_for.h>
+#include <atomic>
+#include <stdexcept>
+
+namespace test {
+
+TEST(vertex, AtomicBitmap) {
+  auto bitmap = vertex::atomic_bitmap(130);
+  EXPECT_EQ(std::size_t(130), bitmap.size());
+  EXPECT_FALSE(bitmap.test(129));
+  EXPECT_TRUE(bitmap.set(129));
+  EXPECT_FALSE(bitmap.set(129));
+  EXPECT_TRUE(bitmap.test(129));
+  EXPECT_FALSE(bitmap.test(65));
+  bitmap.reset();
+  EXPECT_FALSE(bitmap.test(129));
+}
+
+TEST(vertex, ParallelFor) {
+  auto bitmap = vertex::atomic_bitmap(10000);
+  auto claimed = std::atomic<std::size_t>(0);
+  vertex::parallel_for(
+      bitmap.size(), 4,
+      [&](std::size_t first, std::size_t last, std::size_t chunk) {
+        EXPECT_LT(chunk, std::size_t(4));
+        for (; first != last; ++first) {
+          claimed += bitmap.set(first) ? 1 : 0;
+        }
+      },
+      100);
+  EXPECT_EQ(bitmap.size(), claimed.load());
+
+  auto chunks = std::atomic<std::size_t>(0);
+  vertex::parallel_for(10, 4, [&](std::size_t, std::size_t, std::size_t) {
+    ++chunks;  // too small to split at the default grain
+  });
+  EXPECT_EQ(std::size_t(1), chunks.load());
+
+  EXPECT_THROW(vertex::parallel_for(
+                   1000, 4,
+                   [](std::size_t first, std::size_t, std::size_t) {
+                     if (first != 0) {
+                       throw std::runtime_error("worker");
+                     }
+                   },
+                   1),
+               std::runtime_error);
+}
+
+}  // namespace test
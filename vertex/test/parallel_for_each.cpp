@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <vertex/parallel_for_each.h>
+#include <vertex/pod_node.h>
+#include <atomic>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using TestNode = vertex::pod_node<std::string, std::size_t>;
+using Container = std::map<std::string, TestNode>;
+using LinkArray = typename TestNode::container_type;
+
+/** A complete ternary tree of n vertices, in which i links to 3i+1..3i+3 */
+Container ternary_tree(std::size_t n) {
+  auto vertices = Container();
+  for (std::size_t i = 0; i < n; ++i) {
+    auto links = LinkArray();
+    for (auto child = 3 * i + 1; child < n && child <= 3 * i + 3; ++child) {
+      links.push_back(std::to_string(child));
+    }
+    vertices.emplace(std::to_string(i), TestNode(i, links));
+  }
+  return vertices;
+}
+
+}  // namespace
+
+namespace vertex {
+
+TEST(vertex, ParallelForEach) {
+  const auto n = std::size_t(3000);
+  auto vertices = ternary_tree(n);
+  auto visits = std::vector<std::atomic<int>>(n);
+  auto options = parallel_for_each_options();
+  options.threads = 4;
+  options.cutoff = 3;
+  parallel_for_each(
+      vertices, vertices.find("0"),
+      [&visits](const Container::value_type& v) { ++visits[*v.second]; },
+      unconditional<Container>(), options);
+  for (std::size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(1, visits[i].load()) << i;
+  }
+
+  // edge predicates behave as in the sequential traversals
+  auto count = std::atomic<std::size_t>(0);
+  parallel_for_each(
+      vertices, vertices.find("0"),
+      [&count](const Container::value_type&) { ++count; },
+      predicate_function<Container>([](const edge<Container>& e) {
+        return std::stoul(e.target()) < 40;
+      }),
+      options);
+  EXPECT_EQ(std::size_t(40), count.load());
+
+  parallel_for_each(vertices, vertices.end(),
+                    [](const Container::value_type&) { FAIL(); });
+
+  EXPECT_THROW(parallel_for_each(
+                   vertices, vertices.find("0"),
+                   [](const Container::value_type& v) {
+                     if (*v.second == 100) {
+                       throw std::runtime_error("invalid vertex");
+                     }
+                   },
+                   unconditional<Container>(), options),
+               std::runtime_error);
+}
+
+}  // namespace vertex
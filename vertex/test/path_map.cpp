@@ -91,6 +91,11 @@ TEST(vertex, PathMap) {  // Create a graph of paths
   auto actual_paths = PathArray{};
   std::copy(path_map.begin(), path_map.end(), std::back_inserter(actual_paths));
   EXPECT_EQ(expected_paths, actual_paths);
+  actual_paths.clear();
+  for (auto [path, node] : path_map.entries()) {
+    actual_paths.emplace_back(path.to_path(), node);
+  }
+  EXPECT_EQ(expected_paths, actual_paths);
   EXPECT_NE(vertices["/"], root.second);
   EXPECT_NE(expected_vertices, vertices);
   expected_vertices["/"] = TestNode("Root", LinkArray{"home", "var"});
@@ -120,4 +125,230 @@ TEST(vertex, PathMap) {  // Create a graph of paths
   EXPECT_TRUE(inserted);
 }
 
+TEST(vertex, PathMapSearch) {
+  auto vertices = Container{
+      std::make_pair("/", TestNode("Root", LinkArray{"home", "var"})),
+      std::make_pair("home", TestNode("", LinkArray{"bob"})),
+      std::make_pair("bob", TestNode("Bob", LinkArray{"documents"})),
+      std::make_pair("documents", TestNode("Docs")),
+      std::make_pair("var", TestNode("", LinkArray{"bob"}))};
+  auto path_map = PathMap(vertices).root(vertices.find("/"));
+  EXPECT_EQ(path_map.end(), path_map.search(LinkArray{"usr", "bob"}));
+  EXPECT_EQ(path_map.end(), path_map.search(LinkArray{}));
+
+  // partial match stops at the deepest existing segment
+  auto result = path_map.search(LinkArray{"var", "bob", "photos"});
+  ASSERT_NE(path_map.end(), result);
+  EXPECT_EQ((LinkArray{"var", "bob"}), result->first);
+  EXPECT_EQ("Bob", *result->second);
+  EXPECT_EQ(path_map.end(), path_map.find(LinkArray{"var", "bob", "photos"}));
+
+  // the result can be rewound through its ancestors
+  --result;
+  EXPECT_EQ(LinkArray{"var"}, result->first);
+
+  // and advanced in pre-order from the matched vertex
+  result = path_map.find(LinkArray{"home", "bob"});
+  ASSERT_NE(path_map.end(), result);
+  ++result;
+  ASSERT_NE(path_map.end(), result);
+  EXPECT_EQ((LinkArray{"home", "bob", "documents"}), result->first);
+}
+
+TEST(vertex, PathMapEntries) {
+  auto vertices = Container{
+      std::make_pair("/", TestNode("Root", LinkArray{"home", "var"})),
+      std::make_pair("home", TestNode("", LinkArray{"bob"})),
+      std::make_pair("bob", TestNode("Bob", LinkArray{"documents"})),
+      std::make_pair("documents", TestNode("Docs")),
+      std::make_pair("var", TestNode("", LinkArray{"bob"}))};
+  auto path_map = PathMap(vertices).root(vertices.find("/"));
+  auto entries = path_map.entries();
+  auto it = entries.begin();
+  ASSERT_NE(entries.end(), it);
+  EXPECT_EQ(LinkArray{"home"}, it->path);
+  ++it;
+  EXPECT_EQ((LinkArray{"home", "bob"}), it->path);
+  EXPECT_EQ("bob", it->path.back());
+  EXPECT_EQ(2u, it->path.size());
+  // the node is the stored vertex, not a copy
+  EXPECT_EQ(&vertices.find("bob")->second, &(*it).node);
+  ++it;
+  EXPECT_EQ((LinkArray{"home", "bob", "documents"}), it->path);
+  ++it;
+  EXPECT_EQ(LinkArray{"var"}, it->path);
+  ++it;
+  EXPECT_EQ((LinkArray{"var", "bob"}), it->path);
+  ++it;
+  EXPECT_EQ((LinkArray{"var", "bob", "documents"}), it->path);
+  EXPECT_EQ("Docs", *it->node);
+  ++it;
+  EXPECT_EQ(entries.end(), it);
+
+  path_map.root(vertices.end());
+  EXPECT_TRUE(path_map.entries().empty());
+}
+
+TEST(vertex, PathMapSubtree) {
+  auto vertices = Container{
+      std::make_pair("/", TestNode("Root", LinkArray{"home", "var"})),
+      std::make_pair("home", TestNode("", LinkArray{"bob", "jim"})),
+      std::make_pair("bob", TestNode("Bob", LinkArray{"documents", "photos"})),
+      std::make_pair("documents", TestNode("Docs", LinkArray{"plans.doc"})),
+      std::make_pair("plans.doc", TestNode("Plans")),
+      std::make_pair("photos", TestNode("Pictures")),
+      std::make_pair("jim", TestNode("Jim")),
+      std::make_pair("var", TestNode("", LinkArray{"log"})),
+      std::make_pair("log", TestNode("Logs"))};
+  auto path_map = PathMap(vertices).root(vertices.find("/"));
+  auto list = [](auto range) {
+    auto result = std::vector<LinkArray>();
+    for (const auto& entry : range) {
+      result.push_back(entry.path.to_path());
+    }
+    return result;
+  };
+  using Paths = std::vector<LinkArray>;
+  EXPECT_EQ((Paths{{"home", "bob", "documents"},
+                   {"home", "bob", "documents", "plans.doc"},
+                   {"home", "bob", "photos"}}),
+            list(path_map.subtree(LinkArray{"home", "bob"})));
+  EXPECT_EQ((Paths{{"home", "bob", "documents"}, {"home", "bob", "photos"}}),
+            list(path_map.children(LinkArray{"home", "bob"})));
+  EXPECT_EQ((Paths{{"home"},
+                   {"home", "bob"},
+                   {"home", "jim"},
+                   {"var"},
+                   {"var", "log"}}),
+            list(path_map.subtree(LinkArray{}, 2)));
+  EXPECT_EQ((Paths{{"home"}, {"var"}}), list(path_map.children(LinkArray{})));
+  EXPECT_EQ(list(path_map.entries()), list(path_map.subtree(LinkArray{})));
+
+  EXPECT_TRUE(path_map.children(LinkArray{"var", "log"}).empty());
+  EXPECT_TRUE(path_map.subtree(LinkArray{"home", "alice"}).empty());
+  EXPECT_TRUE(path_map.subtree(LinkArray{"jim"}).empty());  // not at the root
+}
+
+TEST(vertex, PathMapLoad) {
+  auto paths = PathArray{
+      std::make_pair(LinkArray{"home"}, TestNode("Home")),
+      std::make_pair(LinkArray{"home", "bob"}, TestNode("Bob")),
+      std::make_pair(LinkArray{"home", "bob", "documents"}, TestNode("Docs")),
+      std::make_pair(LinkArray{"home", "bob", "photos"}, TestNode("Pics")),
+      std::make_pair(LinkArray{"home", "bob", "photos"}, TestNode("Again")),
+      std::make_pair(LinkArray{"home", "jim"}, TestNode("Jim")),
+      std::make_pair(LinkArray{"var", "log", "messages"}, TestNode("Log"))};
+  auto vertices = Container();
+  auto path_map = PathMap(vertices);
+  EXPECT_EQ(0u, path_map.load(paths.begin(), paths.begin()));
+  EXPECT_TRUE(vertices.empty());
+  EXPECT_EQ(6u, path_map.load(paths.begin(), paths.end()));
+  auto expected_vertices = Container{
+      std::make_pair("", TestNode("", LinkArray{"home", "var"})),
+      std::make_pair("home", TestNode("Home", LinkArray{"bob", "jim"})),
+      std::make_pair("bob", TestNode("Bob", LinkArray{"documents", "photos"})),
+      std::make_pair("documents", TestNode("Docs")),
+      std::make_pair("photos", TestNode("Pics")),
+      std::make_pair("jim", TestNode("Jim")),
+      std::make_pair("var", TestNode("", LinkArray{"log"})),
+      std::make_pair("log", TestNode("", LinkArray{"messages"})),
+      std::make_pair("messages", TestNode("Log"))};
+  EXPECT_EQ(expected_vertices, vertices);
+  EXPECT_EQ(vertices.find(""), path_map.root());
+  auto result = path_map.find(LinkArray{"home", "bob", "photos"});
+  ASSERT_NE(path_map.end(), result);
+  EXPECT_EQ("Pics", *result->second);
+
+  // loading into a populated map keeps existing paths and their links
+  auto more = PathArray{
+      std::make_pair(LinkArray{"var", "log", "secure"}, TestNode("Secure")),
+      std::make_pair(LinkArray{"home", "bob"}, TestNode("Robert")),
+      std::make_pair(LinkArray{"home", "alice"}, TestNode("Alice"))};
+  EXPECT_EQ(2u, path_map.load(more.begin(), more.end()));  // unsorted
+  expected_vertices["home"] =
+      TestNode("Home", LinkArray{"bob", "jim", "alice"});
+  expected_vertices["log"] = TestNode("", LinkArray{"messages", "secure"});
+  expected_vertices["secure"] = TestNode("Secure");
+  expected_vertices["alice"] = TestNode("Alice");
+  EXPECT_EQ(expected_vertices, vertices);
+  EXPECT_EQ(10u, std::distance(path_map.begin(), path_map.end()));
+}
+
+TEST(vertex, PathMapBatchInsert) {
+  auto vertices = Container{
+      std::make_pair("/", TestNode("Root", LinkArray{"home"})),
+      std::make_pair("home", TestNode("", LinkArray{"bob"})),
+      std::make_pair("bob", TestNode("Bob", LinkArray{"documents"})),
+      std::make_pair("documents", TestNode("Docs"))};
+  auto path_map = PathMap(vertices).root(vertices.find("/"));
+  auto batch = PathArray{
+      std::make_pair(LinkArray{"var", "log"}, TestNode("Logs")),
+      std::make_pair(LinkArray{"home", "bob", "photos"}, TestNode("Pics")),
+      std::make_pair(LinkArray{"home", "bob"}, TestNode("Robert")),
+      std::make_pair(LinkArray{"home", "jim"}, TestNode("Jim")),
+      std::make_pair(LinkArray{"var", "log"}, TestNode("Logs 2"))};
+  EXPECT_EQ(3u, path_map.insert(batch.begin(), batch.end()));
+  auto expected_vertices = Container{
+      std::make_pair("/", TestNode("Root", LinkArray{"home", "var"})),
+      std::make_pair("home", TestNode("", LinkArray{"bob", "jim"})),
+      std::make_pair("bob", TestNode("Bob", LinkArray{"documents", "photos"})),
+      std::make_pair("documents", TestNode("Docs")),
+      std::make_pair("photos", TestNode("Pics")),
+      std::make_pair("jim", TestNode("Jim")),
+      std::make_pair("var", TestNode("", LinkArray{"log"})),
+      std::make_pair("log", TestNode("Logs"))};
+  EXPECT_EQ(expected_vertices, vertices);
+
+  // an upsert replaces existing nodes, keeping their children
+  EXPECT_EQ(0u, path_map.insert_or_assign(batch.begin(), batch.end()));
+  expected_vertices["bob"] =
+      TestNode("Robert", LinkArray{"documents", "photos"});
+  expected_vertices["log"] = TestNode("Logs 2");
+  EXPECT_EQ(expected_vertices, vertices);
+
+  // a single insert creates every missing level below an existing prefix
+  auto path = LinkArray{"home", "bob", "music", "jazz"};
+  auto [it, inserted] = path_map.insert(std::make_pair(path, TestNode("Sax")));
+  EXPECT_TRUE(inserted);
+  ASSERT_NE(path_map.end(), it);
+  EXPECT_EQ(path, it->first);
+  EXPECT_EQ("Sax", *it->second);
+  EXPECT_EQ(TestNode("", LinkArray{"jazz"}), vertices["music"]);
+  EXPECT_EQ(TestNode("Robert", LinkArray{"documents", "photos", "music"}),
+            vertices["bob"]);
+}
+
+TEST(vertex, PathMapGlob) {
+  auto vertices = Container{
+      std::make_pair("/", TestNode("Root", LinkArray{"home", "var"})),
+      std::make_pair("home", TestNode("", LinkArray{"bob", "jim"})),
+      std::make_pair("bob", TestNode("Bob", LinkArray{"documents"})),
+      std::make_pair("jim", TestNode("Jim", LinkArray{"documents"})),
+      std::make_pair("documents", TestNode("Docs", LinkArray{"a.log"})),
+      std::make_pair("a.log", TestNode("Log")),
+      std::make_pair("var", TestNode("", LinkArray{"log"})),
+      std::make_pair("log", TestNode("", LinkArray{"a.log"}))};
+  auto path_map = PathMap(vertices).root(vertices.find("/"));
+  auto list = [](auto range) {
+    auto result = std::vector<LinkArray>();
+    for (const auto& entry : range) {
+      result.push_back(entry.path.to_path());
+    }
+    return result;
+  };
+  using Paths = std::vector<LinkArray>;
+  EXPECT_EQ((Paths{{"home", "bob", "documents", "a.log"},
+                   {"home", "jim", "documents", "a.log"}}),
+            list(path_map.glob("/home/*/documents/**.log")));
+  EXPECT_EQ((Paths{{"home", "bob"}, {"home", "jim"}}),
+            list(path_map.glob("home/[a-j]*")));
+  EXPECT_EQ(list(path_map.entries()), list(path_map.glob("**")));
+  EXPECT_TRUE(path_map.glob("home/alice/**").empty());
+  auto match = path_map.glob("var/log/*").begin();
+  EXPECT_EQ(&vertices.find("a.log")->second, &(*match).node);
+
+  path_map.root(vertices.end());
+  EXPECT_TRUE(path_map.glob("**").empty());
+}
+
 }  // namespace test
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <vertex/pod_node.h>
+#include <vertex/small_vector.h>
+#include <string>
+#include "link.h"
+
+namespace test {
+
+using LinkVector = vertex::small_vector<TestLink, 4>;
+using SmallNode = vertex::pod_node<TestLink, std::string, LinkVector>;
+
+TEST(vertex, SmallVector) {
+  auto links = LinkVector{TestLink(1, "one"), TestLink(2, "two")};
+  EXPECT_TRUE(links.is_inline());
+  EXPECT_EQ(std::size_t(2), links.size());
+  EXPECT_EQ(TestLink(1, "one"), links.front());
+
+  links.insert(links.begin(), TestLink(0, "zero"));
+  links.push_back(TestLink(3, "three"));
+  EXPECT_TRUE(links.is_inline());
+  links.push_back(TestLink(4, "four"));  // exceeds the inline buffer
+  EXPECT_FALSE(links.is_inline());
+  EXPECT_EQ(std::size_t(5), links.size());
+  for (auto i = 0u; i < links.size(); ++i) {
+    EXPECT_EQ(i, links[i].key());
+  }
+
+  auto copy = links;
+  EXPECT_EQ(links, copy);
+  auto moved = std::move(copy);
+  EXPECT_EQ(links, moved);
+  EXPECT_TRUE(copy.empty());
+
+  auto it = links.erase(links.begin() + 1, links.begin() + 3);
+  EXPECT_EQ(TestLink(3, "three"), *it);
+  EXPECT_EQ(std::size_t(3), links.size());
+  links.erase(links.begin());
+  EXPECT_EQ(TestLink(3, "three"), links.front());
+  EXPECT_EQ(TestLink(4, "four"), links.back());
+
+  auto small = LinkVector{TestLink(7)};
+  small = moved;
+  EXPECT_EQ(moved, small);
+  small = LinkVector{TestLink(8)};
+  EXPECT_EQ(std::size_t(1), small.size());
+  EXPECT_EQ(TestLink(8), small.front());
+}
+
+TEST(vertex, SmallVectorNode) {
+  auto node = SmallNode("small");
+  node.insert(TestLink(1));
+  node.insert(TestLink(2));
+  EXPECT_FALSE(node.insert(TestLink(2)).second);
+  EXPECT_EQ(std::size_t(2), node.size());
+  EXPECT_NE(node.end(), node.find(TestLink(1)));
+
+  auto copy = node;
+  EXPECT_EQ(node, copy);
+  copy.insert(TestLink(3));
+  EXPECT_NE(node, copy);
+  EXPECT_EQ(std::size_t(1), copy.erase(TestLink(1)));
+  EXPECT_EQ(std::size_t(2), copy.size());
+
+  using OrderedNode = vertex::pod_node<TestLink, std::string, LinkVector,
+                                       vertex::ordered_links>;
+  auto ordered = OrderedNode("ordered", {TestLink(5), TestLink(1)});
+  auto children = std::vector<TestLink>{TestLink(4), TestLink(2), TestLink(3)};
+  ordered.insert(children.begin(), children.end());
+  EXPECT_EQ(std::size_t(5), ordered.size());
+  EXPECT_TRUE(std::is_sorted(ordered.begin(), ordered.end()));
+}
+
+}  // namespace test
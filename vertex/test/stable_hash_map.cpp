@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <vertex/path_map.h>
+#include <vertex/breadth_first_traversal.h>
+#include <vertex/pod_node.h>
+#include <vertex/prefetch.h>
+#include <vertex/pre_order_traversal.h>
+#include <vertex/stable_hash_map.h>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace test {
+
+using TestNode = vertex::pod_node<std::string, std::string>;
+using HashMap = vertex::stable_hash_map<std::string, TestNode>;
+using LinkArray = std::vector<std::string>;
+
+TEST(vertex, StableHashMap) {
+  auto map = HashMap();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.end(), map.find("missing"));
+
+  auto [first, inserted] = map.emplace("0", TestNode("zero"));
+  EXPECT_TRUE(inserted);
+  EXPECT_FALSE(map.emplace("0", TestNode("other")).second);
+  EXPECT_EQ("zero", *first->second);
+  const auto* address = &*first;
+
+  for (auto i = 1; i < 1000; ++i) {  // grow well beyond the initial table
+    auto key = std::to_string(i);
+    map.insert(std::make_pair(key, TestNode(key)));
+  }
+  EXPECT_EQ(std::size_t(1000), map.size());
+  EXPECT_LE(map.load_factor(), 0.75f);
+  EXPECT_EQ(address, &*map.find("0"));  // elements never move
+  EXPECT_EQ(first, map.find("0"));
+
+  for (auto i = 0; i < 1000; i += 2) {
+    EXPECT_EQ(std::size_t(1), map.erase(std::to_string(i)));
+  }
+  EXPECT_EQ(std::size_t(500), map.size());
+  EXPECT_EQ(std::size_t(0), map.count("0"));
+  for (auto i = 1; i < 1000; i += 2) {  // survivors remain reachable
+    auto it = map.find(std::to_string(i));
+    ASSERT_NE(map.end(), it);
+    EXPECT_EQ(std::to_string(i), *it->second);
+  }
+  EXPECT_EQ(std::size_t(500), std::distance(map.begin(), map.end()));
+
+  auto copy = map;
+  EXPECT_EQ(map, copy);
+  copy["1"] = TestNode("changed");
+  EXPECT_NE(map, copy);
+
+  for (auto it = copy.begin(); it != copy.end();) {
+    it = copy.erase(it);
+  }
+  EXPECT_TRUE(copy.empty());
+  map.clear();
+  EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(vertex, StableHashMapReverseErase) {
+  auto map = HashMap();
+  auto positions = std::vector<HashMap::iterator>();
+  for (auto i = 0; i < 1000; ++i) {  // spans several chunks of slots
+    auto key = std::to_string(i);
+    positions.push_back(map.try_emplace(key, TestNode(key)).first);
+  }
+
+  // erasing the last element leaves no successor, however many slots
+  // below it remain occupied
+  for (auto i = 999; i >= 500; --i) {
+    EXPECT_EQ(map.end(), map.erase(positions[i]));
+    EXPECT_EQ(std::size_t(i), map.size());
+  }
+  EXPECT_EQ(positions[1], map.erase(positions[0]));
+  map.quick_erase(positions[1]);
+  for (auto i = 499; i >= 2; --i) {
+    EXPECT_EQ(std::size_t(1), map.erase(std::to_string(i)));
+  }
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(std::size_t(0), map.erase("0"));
+
+  // erased slots are reused, and iteration finds them again
+  for (auto i = 0; i < 100; ++i) {
+    auto key = std::to_string(i);
+    map.try_emplace(key, TestNode(key));
+  }
+  EXPECT_EQ(std::size_t(100), std::distance(map.begin(), map.end()));
+  for (const auto& [key, node] : map) {
+    EXPECT_EQ(key, *node);
+  }
+}
+
+TEST(vertex, StableHashMapTraversal) {
+  auto vertices = HashMap{
+      std::make_pair("/", TestNode("Root", LinkArray{"home", "var"})),
+      std::make_pair("home", TestNode("Home", LinkArray{"bob"})),
+      std::make_pair("bob", TestNode("Bob")),
+      std::make_pair("var", TestNode("Var"))};
+  auto output = std::ostringstream();
+  for (const auto& v :
+       vertex::pre_order_traversal<HashMap>(vertices, vertices.find("/"))) {
+    output << *v.second;
+  }
+  EXPECT_EQ("RootHomeBobVar", output.str());
+
+  auto path_map = vertex::path_map<HashMap>(vertices).root(vertices.find("/"));
+  auto result = path_map.find(LinkArray{"home", "bob"});
+  ASSERT_NE(path_map.end(), result);
+  EXPECT_EQ("Bob", *result->second);
+  auto path = LinkArray{"var", "log"};
+  path_map.insert(std::make_pair(path, TestNode("Log")));
+  result = path_map.find(path);
+  ASSERT_NE(path_map.end(), result);
+  EXPECT_EQ("Log", *result->second);
+}
+
+TEST(vertex, StableHashMapFindMany) {
+  auto map = vertex::stable_hash_map<int, int>();
+  for (auto i = 0; i < 1000; i += 2) {
+    map.emplace(i, -i);
+  }
+  auto keys = std::vector<int>();
+  for (auto i = 0; i < 100; ++i) {
+    keys.push_back(i * 7);
+  }
+  auto found = std::vector<vertex::stable_hash_map<int, int>::const_iterator>();
+  vertex::find_many(map, keys.begin(), keys.end(), std::back_inserter(found));
+  ASSERT_EQ(keys.size(), found.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(map.find(keys[i]), found[i]);
+  }
+
+  // containers without find_many fall back to find
+  auto ordered = std::map<int, int>(map.begin(), map.end());
+  auto ordered_found = std::vector<std::map<int, int>::const_iterator>();
+  vertex::find_many(ordered, keys.begin(), keys.end(),
+                    std::back_inserter(ordered_found));
+  ASSERT_EQ(keys.size(), ordered_found.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(ordered.find(keys[i]), ordered_found[i]);
+  }
+
+  auto empty = vertex::stable_hash_map<int, int>();
+  found.clear();
+  empty.find_many(keys.begin(), keys.end(), std::back_inserter(found));
+  ASSERT_EQ(keys.size(), found.size());
+  EXPECT_EQ(empty.end(), found.back());
+}
+
+TEST(vertex, StableHashMapWideTraversal) {
+  auto vertices = HashMap();
+  auto links = LinkArray();
+  for (auto i = 0; i < 100; ++i) {
+    auto key = std::to_string(i);
+    vertices.emplace(key, TestNode(key));
+    links.push_back(key);
+  }
+  links.push_back("missing");
+  vertices.emplace("/", TestNode("/", links));
+  auto order = [](auto traversal) {
+    auto output = std::ostringstream();
+    for (const auto& v : traversal) {
+      output << *v.second << ",";
+    }
+    return output.str();
+  };
+  auto expected = std::string("/,");
+  for (auto i = 0; i < 100; ++i) {
+    expected += std::to_string(i) + ",";
+  }
+  auto root = vertices.find("/");
+  EXPECT_EQ(expected,
+            order(vertex::pre_order_traversal<HashMap>(vertices, root)));
+  EXPECT_EQ(expected,
+            order(vertex::breadth_first_traversal<HashMap>(vertices, root)));
+
+  auto traversal = vertex::pre_order_traversal<HashMap>(vertices, root);
+  EXPECT_TRUE(traversal.descend("50"));
+  EXPECT_EQ("51", (++traversal)->first);
+}
+
+}  // namespace test
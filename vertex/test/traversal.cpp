@@ -6,6 +6,8 @@
 #include <vertex/post_order_traversal.h>
 #include <vertex/pre_order_traversal.h>
 #include <functional>
+#include <sstream>
+#include <string>
 
 namespace {
 
@@ -18,6 +20,15 @@ std::ostream& operator<<(std::ostream& output, const TestNode& vertex) {
   return output;
 }
 
+template <typename Traversal>
+std::string depths(Traversal traversal) {
+  auto output = std::ostringstream();
+  for (auto it = traversal.begin(), end = traversal.end(); it != end; ++it) {
+    output << it->second << it.depth();
+  }
+  return output.str();
+}
+
 }  // namespace
 
 namespace vertex {
@@ -64,6 +75,173 @@ TEST_F(Graph, PreOrderTraversal) {
   }
 }
 
+TEST_F(Graph, WidePreOrderTraversal) {
+  vertices.clear();
+  auto root = TestNode("root");
+  for (auto i = 0; i < 5000; ++i) {
+    auto key = std::to_string(i);
+    vertices.insert(std::make_pair(key, TestNode(key)));
+    root.insert(key);
+  }
+  root.insert("missing");  // unresolved links are skipped
+  vertices.insert(std::make_pair("root", root));
+  auto traversal =
+      pre_order_traversal<Container>(vertices, vertices.find("root"));
+  auto count = 0;
+  for (const auto& v : traversal) {
+    EXPECT_EQ(count == 0 ? "root" : std::to_string(count - 1), *v.second);
+    ++count;
+  }
+  EXPECT_EQ(5001, count);
+}
+
+TEST_F(Graph, DescendPreOrderTraversal) {
+  using Pot = pre_order_traversal<Container>;
+  auto traversal = Pot(vertices, vertices.find("1"));
+  EXPECT_FALSE(traversal.descend("3"));  // not a child of 1
+  ASSERT_TRUE(traversal.descend("7"));
+  EXPECT_FALSE(traversal.descend("8"));
+  // resumes with the siblings after the vertex descended to
+  auto vertex_order = std::ostringstream();
+  for (; traversal != traversal.end(); ++traversal) {
+    vertex_order << traversal->second;
+  }
+  EXPECT_EQ("789101112", vertex_order.str());
+}
+
+TEST_F(Graph, CopiedTraversal) {
+  using Pot = pre_order_traversal<Container>;
+  auto traversal = Pot(vertices, vertices.find("1"));
+  std::advance(traversal, 3);
+  auto copy = traversal;  // copies advance independently
+  auto rest = [](Pot it) {
+    auto vertex_order = std::ostringstream();
+    for (; it != it.end(); ++it) {
+      vertex_order << it->second;
+    }
+    return vertex_order.str();
+  };
+  EXPECT_EQ("456789101112", rest(traversal));
+  EXPECT_EQ("4", *copy++->second);
+  EXPECT_EQ("56789101112", rest(copy));
+  EXPECT_EQ("456789101112", rest(traversal));
+}
+
+TEST(vertex, StatefulPredicateCopiedTraversal) {
+  auto vertices = Container{
+      std::make_pair("a", TestNode("a", LinkArray{"b", "c"})),
+      std::make_pair("b", TestNode("b", LinkArray{"d"})),
+      std::make_pair("c", TestNode("c")),
+      std::make_pair("d", TestNode("d"))};
+  using Pot = pre_order_traversal<Container>;
+  auto rest = [](Pot it) {
+    auto vertex_order = std::ostringstream();
+    for (; it != it.end(); ++it) {
+      vertex_order << it->second;
+    }
+    return vertex_order.str();
+  };
+  // a counting predicate, which admits two edges per iterator
+  auto predicate = predicate_function<Container>(
+      [n = 0](const edge<Container>&) mutable { return n++ < 2; });
+  auto traversal = Pot(vertices, vertices.find("a"), predicate);
+  auto copy = traversal;  // each copy counts from where it was copied
+  EXPECT_EQ("abd", rest(traversal));
+  EXPECT_EQ("abd", rest(copy));
+  auto advanced = traversal;
+  ++advanced;
+  EXPECT_EQ("abd", rest(traversal));
+  EXPECT_EQ("bd", rest(advanced));
+
+  static_assert(is_shareable_predicate_v<Container, unconditional<Container>>);
+  static_assert(!is_shareable_predicate_v<Container,
+                                          predicate_function<Container>>);
+  static_assert(
+      !is_shareable_predicate_v<Container, MaxDepthPredicate<Container>>);
+}
+
+TEST(vertex, VisitedSetTraversal) {
+  /*******************\
+   *     A <----+     *
+   *    / \     |     *
+   *   B   C    |     *
+   *   |\ /|    |     *
+   *   | X |    |     *
+   *   |/ \|    |     *
+   *   D   E ---+     *
+  \*******************/
+  auto vertices = Container();
+  vertices.emplace("A", TestNode("A", LinkArray{"B", "C"}));
+  vertices.emplace("B", TestNode("B", LinkArray{"D", "E"}));
+  vertices.emplace("C", TestNode("C", LinkArray{"D", "E"}));
+  vertices.emplace("D", TestNode("D"));
+  vertices.emplace("E", TestNode("E", LinkArray{"A"}));
+  auto order = [](auto traversal) {
+    auto vertex_order = std::ostringstream();
+    for (const auto& v : traversal) {
+      vertex_order << v.second;
+    }
+    return vertex_order.str();
+  };
+  using All = unconditional<Container>;
+  using Visited = visited_set<Container>;
+  auto a = vertices.find("A");
+  EXPECT_EQ("ABDEC",
+            order(pre_order_traversal<Container, All, Visited>(vertices, a)));
+  EXPECT_EQ("DEBCA",
+            order(post_order_traversal<Container, All, Visited>(vertices, a)));
+  EXPECT_EQ("DBEAC",
+            order(in_order_traversal<Container, All, Visited>(vertices, a)));
+  EXPECT_EQ("ABCDE", order(breadth_first_traversal<Container, All, Visited>(
+                         vertices, a)));
+
+  // without a cycle, the shared children are otherwise visited twice
+  vertices.find("E")->second.erase("A");
+  EXPECT_EQ("ABDECDE", order(pre_order_traversal<Container>(vertices, a)));
+  EXPECT_EQ("ABDEC",
+            order(pre_order_traversal<Container, All, Visited>(vertices, a)));
+}
+
+/** A visited_set which counts how often it is copied */
+struct counted_visited_set : visited_set<Container> {
+  static inline int copies = 0;
+
+  counted_visited_set() = default;
+
+  counted_visited_set(const counted_visited_set& other)
+      : visited_set<Container>(other) {
+    ++copies;
+  }
+};
+
+TEST(vertex, VisitedSetPostfixIncrement) {
+  auto vertices = Container();
+  vertices.emplace("A", TestNode("A", LinkArray{"B", "C"}));
+  vertices.emplace("B", TestNode("B", LinkArray{"C"}));
+  vertices.emplace("C", TestNode("C", LinkArray{"A"}));
+  using Traversal = pre_order_traversal<Container, unconditional<Container>,
+                                        counted_visited_set>;
+  auto traversal = Traversal(vertices, vertices.find("A"));
+  counted_visited_set::copies = 0;
+
+  auto order = std::string();
+  for (auto it = traversal.begin(), end = traversal.end(); it != end;) {
+    order += (it++)->first;
+  }
+  EXPECT_EQ("ABC", order);
+  EXPECT_EQ(0, counted_visited_set::copies);
+
+  // advancing a copy which shares the set clones it
+  auto it = traversal.begin();
+  auto copy = it;
+  ++copy;
+  EXPECT_EQ(1, counted_visited_set::copies);
+  EXPECT_EQ("B", copy->first);
+  ++it;
+  EXPECT_EQ("B", it->first);
+  EXPECT_EQ(1, counted_visited_set::copies);
+}
+
 struct tree : public ::testing::Test {
   Container vertices;
 
@@ -203,6 +381,64 @@ TEST_F(tree, MaxDepthBreadthFirstTraversal) {
   }
 }
 
+TEST_F(tree, StaticPredicateTraversal) {
+  auto order = [](auto traversal) {
+    auto vertex_order = std::ostringstream();
+    for (const auto& v : traversal) {
+      vertex_order << v.second;
+    }
+    return vertex_order.str();
+  };
+  using All = unconditional<Container>;
+  auto f = vertices.find("F");
+  EXPECT_EQ(order(pre_order_traversal<Container>(vertices, f)),
+            order(pre_order_traversal<Container, All>(vertices, f)));
+  EXPECT_EQ(order(post_order_traversal<Container>(vertices, f)),
+            order(post_order_traversal<Container, All>(vertices, f)));
+  EXPECT_EQ(order(in_order_traversal<Container>(vertices, f)),
+            order(in_order_traversal<Container, All>(vertices, f)));
+  EXPECT_EQ(order(breadth_first_traversal<Container>(vertices, f)),
+            order(breadth_first_traversal<Container, All>(vertices, f)));
+
+  using Predicate = MaxDepthPredicate<Container>;
+  EXPECT_EQ("FBGADI", order(breadth_first_traversal<Container, Predicate>(
+                          vertices, f, Predicate(2))));
+}
+
+TEST_F(tree, DepthTraversal) {
+  using All = unconditional<Container>;
+  auto f = vertices.find("F");
+  EXPECT_EQ("F0B1A2D2C3E3G1I2H3",
+            depths(pre_order_traversal<Container, All>(vertices, f)));
+  EXPECT_EQ("A2C3E3D2B1H3I2G1F0",
+            depths(post_order_traversal<Container, All>(vertices, f)));
+  EXPECT_EQ("A2B1C3D2E3F0G1H3I2",
+            depths(in_order_traversal<Container, All>(vertices, f)));
+  EXPECT_EQ("F0B1G1A2D2I2C3E3H3",
+            depths(breadth_first_traversal<Container, All>(vertices, f)));
+}
+
+TEST_F(tree, MaxDepthTraversal) {
+  using All = unconditional<Container>;
+  auto f = vertices.find("F");
+  EXPECT_EQ("F0B1A2D2G1I2",
+            depths(pre_order_traversal<Container, All>(vertices, f, {}, 2)));
+  EXPECT_EQ("A2D2B1I2G1F0",
+            depths(post_order_traversal<Container, All>(vertices, f, {}, 2)));
+  EXPECT_EQ("A2B1D2F0G1I2",
+            depths(in_order_traversal<Container, All>(vertices, f, {}, 2)));
+  EXPECT_EQ("F0B1G1A2D2I2", depths(breadth_first_traversal<Container, All>(
+                                vertices, f, {}, 2)));
+  EXPECT_EQ("F0", depths(pre_order_traversal<Container>(vertices, f, {}, 0)));
+
+  // descend stops at max_depth as well
+  auto traversal = pre_order_traversal<Container, All>(vertices, f, {}, 1);
+  EXPECT_TRUE(traversal.descend("B"));
+  EXPECT_EQ(1u, traversal.depth());
+  EXPECT_FALSE(traversal.descend("D"));
+  EXPECT_EQ("B", traversal->first);
+}
+
 TEST_F(tree, PostOrderTraversal) {
   using Pot = post_order_traversal<Container>;
   auto traversal = Pot(vertices, vertices.find("F"));
@@ -1,13 +1,42 @@
 #pragma once
 
+#include <vertex/copy_on_write.h>
 #include <vertex/edge.h>
 #include <vertex/predicate.h>
+#include <vertex/visited_set.h>
+#include <cstddef>
 #include <functional>
+#include <limits>
+#include <type_traits>
 #include <utility>
 
 namespace vertex {
 
-template <typename Container, typename Impl>
+/** Base of the traversals of a Container, which supply next() through Impl.
+ *
+ * Predicate decides whether each edge is traversed. It defaults to the
+ * type-erased predicate_function; passing e.g. unconditional<Container> or
+ * MaxDepthPredicate<Container> instead lets each test inline.
+ *
+ * A traversal reports the depth() of its position, counted in edges from
+ * the root, and does not descend below max_depth.
+ *
+ * Visited records the vertices entered. The default no_visited_set walks a
+ * shared subtree once per parent; visited_set<Container> enters every
+ * distinct vertex once, which also terminates on cycles.
+ *
+ * Copies of a traversal share its predicate, visited set and the frontier
+ * held by Impl in its to_visit_ member, cloning them only when a copy is
+ * advanced. A stateless predicate, see is_shareable_predicate_v, is never
+ * cloned; any other, including every predicate_function, is cloned like the
+ * frontier, so that each copy continues from the state it was copied in.
+ * In particular, advancing a copy of a traversal with a visited set clones
+ * the whole set. end() returns a sentinel which holds no frontier or visited
+ * set, and the copy returned by postfix ++ holds no visited set either: it
+ * is meant to be dereferenced, and if advanced may enter vertices again. */
+template <typename Container, typename Impl,
+          typename Predicate = predicate_function<Container>,
+          typename Visited = no_visited_set>
 class traversal {
  public:
   using iterator_category = std::forward_iterator_tag;
@@ -17,34 +46,48 @@ class traversal {
   using vertex_type = typename Container::mapped_type;
   using child_iterator = typename vertex_type::container_type::iterator;
   using key_type = typename Container::key_type;
+  using size_type = std::size_t;
   using edge_type = edge<Container>;
-  using predicate_type = std::function<bool(const edge_type&)>;
+  using predicate_type = Predicate;
+  using visited_type = Visited;
 
   using value_type = typename Container::value_type;
-  using self_type = traversal<Container, Impl>;
+  using self_type = traversal<Container, Impl, Predicate, Visited>;
   using reference = value_type&;
   using const_reference = const value_type&;
   using pointer = value_type*;
   using const_pointer = const value_type*;
 
+  /** max_depth which places no limit on the depth of a traversal */
+  static constexpr size_type unlimited = std::numeric_limits<size_type>::max();
+
  protected:
-  class unconditional_traversal {
-   public:
-    bool operator()(const edge<Container>&) { return true; }
-  };
+  using unconditional_traversal = unconditional<Container>;
 
  public:
   traversal() = default;
 
   traversal(const Container& vertices, typename Container::const_iterator root,
-            predicate_type predicate = unconditional_traversal());
+            predicate_type predicate = unconditional_traversal(),
+            size_type max_depth = unlimited);
 
   const Container& vertices() const;
   const vertex_iterator& root() const;
   const vertex_iterator& position() const;
+
+  /** Returns the number of edges from the root to the current position */
+  size_type depth() const;
+
+  /** Returns the depth below which the traversal does not descend */
+  size_type max_depth() const;
+
   const predicate_type& predicate() const;
   bool is_traversable(const edge_type& value);
 
+  /** Tests the edge from source to target, constructing it only if the
+   * predicate is conditional */
+  bool is_traversable(const key_type& source, const key_type& target);
+
   Impl begin() const;
   Impl end() const;
   Impl& operator++();
@@ -58,107 +101,200 @@ class traversal {
  protected:
   void position(const vertex_iterator& value);
 
+  /** Moves to a vertex at the given depth */
+  void position(const vertex_iterator& value, size_type depth);
+
+  /** Records a visit of target, which has passed the predicate
+   * @return false if target has been entered before */
+  bool enter(const vertex_iterator& target);
+
  private:
-  const Container* vertices_;
+  const Container* vertices_ = nullptr;
   vertex_iterator root_;
   vertex_iterator position_;
-  predicate_type predicate_;
+  size_type depth_ = 0;
+  size_type max_depth_ = unlimited;
+  copy_on_write<predicate_type> predicate_;
+  copy_on_write<visited_type> visited_;
 };
 
-template <typename Container, typename Impl>
-traversal<Container, Impl>::traversal(const Container& vertices,
-                                      typename Container::const_iterator root,
-                                      predicate_type predicate)
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+traversal<Container, Impl, Predicate, Visited>::traversal(
+    const Container& vertices, typename Container::const_iterator root,
+    predicate_type predicate, size_type max_depth)
     : vertices_(&vertices),
       root_(std::move(root)),
       position_(root_),
-      predicate_(std::move(predicate)) {}
+      max_depth_(max_depth),
+      predicate_(std::move(predicate)) {
+  if (root_ != vertices.end()) {
+    visited_.mutate().insert(*root_);
+  }
+}
 
-template <typename Container, typename Impl>
-const Container& traversal<Container, Impl>::vertices() const {
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+const Container& traversal<Container, Impl, Predicate, Visited>::vertices()
+    const {
   return *vertices_;
 }
 
-template <typename Container, typename Impl>
-const typename traversal<Container, Impl>::vertex_iterator&
-traversal<Container, Impl>::root() const {
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+const typename traversal<Container, Impl, Predicate, Visited>::vertex_iterator&
+traversal<Container, Impl, Predicate, Visited>::root() const {
   return root_;
 }
 
-template <typename Container, typename Impl>
-const typename traversal<Container, Impl>::vertex_iterator&
-traversal<Container, Impl>::position() const {
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+const typename traversal<Container, Impl, Predicate, Visited>::vertex_iterator&
+traversal<Container, Impl, Predicate, Visited>::position() const {
   return position_;
 }
 
-template <typename Container, typename Impl>
-const typename traversal<Container, Impl>::predicate_type&
-traversal<Container, Impl>::predicate() const {
-  return predicate_;
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+typename traversal<Container, Impl, Predicate, Visited>::size_type
+traversal<Container, Impl, Predicate, Visited>::depth() const {
+  return depth_;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+typename traversal<Container, Impl, Predicate, Visited>::size_type
+traversal<Container, Impl, Predicate, Visited>::max_depth() const {
+  return max_depth_;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+const typename traversal<Container, Impl, Predicate, Visited>::predicate_type&
+traversal<Container, Impl, Predicate, Visited>::predicate() const {
+  return predicate_.get();
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+void traversal<Container, Impl, Predicate, Visited>::position(
+    const vertex_iterator& value) {
+  position_ = value;
 }
 
-template <typename Container, typename Impl>
-void traversal<Container, Impl>::position(
-    const typename traversal<Container, Impl>::vertex_iterator& value) {
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+void traversal<Container, Impl, Predicate, Visited>::position(
+    const vertex_iterator& value, size_type depth) {
   position_ = value;
+  depth_ = depth;
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+bool traversal<Container, Impl, Predicate, Visited>::enter(
+    const vertex_iterator& target) {
+  if constexpr (std::is_same_v<Visited, no_visited_set>) {
+    (void)target;
+    return true;
+  } else {
+    return visited_.mutate().insert(*target);
+  }
+}
+
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+bool traversal<Container, Impl, Predicate, Visited>::is_traversable(
+    const edge_type& value) {
+  if constexpr (is_shareable_predicate_v<Container, Predicate>) {
+    return predicate_.get()(value);  // stateless, so copies may share it
+  } else {
+    return predicate_.mutate()(value);
+  }
 }
 
-template <typename Container, typename Impl>
-bool traversal<Container, Impl>::is_traversable(const edge<Container>& value) {
-  return predicate_(value);
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+bool traversal<Container, Impl, Predicate, Visited>::is_traversable(
+    const key_type& source, const key_type& target) {
+  if constexpr (is_unconditional_v<Container, Predicate>) {
+    (void)source;
+    (void)target;
+    return true;
+  } else {
+    return is_traversable(edge_type(source, target));
+  }
 }
 
-template <typename Container, typename Impl>
-Impl traversal<Container, Impl>::begin() const {
-  return Impl(vertices(), root(), predicate());
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+Impl traversal<Container, Impl, Predicate, Visited>::begin() const {
+  return Impl(vertices(), root(), predicate(), max_depth());
 }
 
-template <typename Container, typename Impl>
-Impl traversal<Container, Impl>::end() const {
-  auto result = Impl(vertices(), root(), predicate());
-  result.position(vertices().end());
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+Impl traversal<Container, Impl, Predicate, Visited>::end() const {
+  auto result = static_cast<const Impl&>(*this);
+  result.position(vertices().end(), 0);
+  result.to_visit_ = decltype(result.to_visit_)();
+  result.visited_ = copy_on_write<visited_type>();
+  if constexpr (!is_shareable_predicate_v<Container, Predicate>) {
+    // unshare a stateful predicate, which would otherwise be cloned by the
+    // next advance of this traversal
+    result.predicate_ = copy_on_write<predicate_type>(predicate());
+  }
   return result;
 }
 
-template <typename Container, typename Impl>
-Impl& traversal<Container, Impl>::operator++() {
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+Impl& traversal<Container, Impl, Predicate, Visited>::operator++() {
   auto pImpl = static_cast<Impl*>(this);
   if (!pImpl->next()) {
-    position(vertices().end());
+    position(vertices().end(), 0);
   }
   return *pImpl;
 }
 
-template <typename Container, typename Impl>
-Impl traversal<Container, Impl>::operator++(int dummy) {
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+Impl traversal<Container, Impl, Predicate, Visited>::operator++(int dummy) {
   (void)dummy;
   auto pImpl = static_cast<Impl*>(this);
   auto copy = *pImpl;
+  // the copy is returned for reading, so it gives up the visited set rather
+  // than have the advance below clone it
+  copy.visited_ = copy_on_write<visited_type>();
   ++*this;
   return copy;
 }
 
-template <typename Container, typename Impl>
-typename traversal<Container, Impl>::const_reference
-    traversal<Container, Impl>::operator*() const {
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+typename traversal<Container, Impl, Predicate, Visited>::const_reference
+    traversal<Container, Impl, Predicate, Visited>::operator*() const {
   return position().operator*();
 }
 
-template <typename Container, typename Impl>
-typename traversal<Container, Impl>::const_pointer
-    traversal<Container, Impl>::operator->() const {
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+typename traversal<Container, Impl, Predicate, Visited>::const_pointer
+    traversal<Container, Impl, Predicate, Visited>::operator->() const {
   return position().operator->();
 }
 
-template <typename Container, typename Impl>
-bool traversal<Container, Impl>::operator==(
-    const traversal<Container, Impl>& rhs) const {
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+bool traversal<Container, Impl, Predicate, Visited>::operator==(
+    const self_type& rhs) const {
   return position() == rhs.position() && root() == rhs.root();
 }
 
-template <typename Container, typename Impl>
-bool traversal<Container, Impl>::operator!=(
-    const traversal<Container, Impl>& rhs) const {
+template <typename Container, typename Impl, typename Predicate,
+          typename Visited>
+bool traversal<Container, Impl, Predicate, Visited>::operator!=(
+    const self_type& rhs) const {
   return !(*this == rhs);
 }
 
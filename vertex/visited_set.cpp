@@ -0,0 +1,20 @@
+#include <vertex/visited_set.h>
+#include <algorithm>
+
+namespace vertex {
+
+bool visited_bitmap::insert(std::size_t index) {
+  if (index >= bits_.size()) {
+    bits_.resize(std::max(index + 1, bits_.size() * 2));
+  }
+  if (bits_[index]) {
+    return false;
+  }
+  bits_[index] = true;
+  ++size_;
+  return true;
+}
+
+std::size_t visited_bitmap::size() const { return size_; }
+
+}  // namespace vertex
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_set>
+#include <vector>
+
+namespace vertex {
+
+/** Visited policy of a traversal which records nothing, so that a vertex
+ * shared by several parents is visited once for each edge reaching it */
+struct no_visited_set {
+  template <typename Vertex>
+  bool insert(const Vertex& /*vertex*/) {
+    return true;
+  }
+};
+
+/** Visited policy which records the address of each vertex entered, so that
+ * every distinct vertex is visited once, and cycles terminate. The Container
+ * must not move its elements during the traversal, e.g. std::map or
+ * stable_hash_map */
+template <typename Container>
+class visited_set {
+ public:
+  using value_type = typename Container::value_type;
+
+  /** Records vertex, returning false if it was already recorded */
+  bool insert(const value_type& vertex);
+
+  /** Returns the number of vertices recorded */
+  [[nodiscard]] std::size_t size() const;
+
+ private:
+  std::unordered_set<const value_type*> vertices_;
+};
+
+/** Visited policy for traversals of indexed vertices, e.g. of a csr_graph,
+ * which records one bit per vertex */
+class visited_bitmap {
+ public:
+  /** Records the vertex at index, returning false if it was already
+   * recorded */
+  bool insert(std::size_t index);
+
+  /** Returns the number of vertices recorded */
+  [[nodiscard]] std::size_t size() const;
+
+ private:
+  std::vector<bool> bits_;
+  std::size_t size_ = 0;
+};
+
+template <typename Container>
+bool visited_set<Container>::insert(const value_type& vertex) {
+  return vertices_.insert(&vertex).second;
+}
+
+template <typename Container>
+std::size_t visited_set<Container>::size() const {
+  return vertices_.size();
+}
+
+}  // namespace vertex